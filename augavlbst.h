@@ -0,0 +1,382 @@
+#ifndef AUGAVLBST_H
+#define AUGAVLBST_H
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <limits>
+#include "avlbst.h"
+
+/**
+ * Monoids for AugmentedAVLTree. A monoid names the aggregate type, its
+ * identity, an associative combine, and how a single item is lifted into an
+ * aggregate. combine need not be commutative: aggregates are always combined
+ * in key order.
+ *
+ * LazyAVLTree additionally needs addAll(agg, delta, count) and
+ * assignAll(value, count): the aggregate of count items after delta was added
+ * to each of them, or after each was set to value.
+ */
+template <typename T>
+struct SumMonoid
+{
+    typedef T value_type;
+    static T identity() { return T(); }
+    static T combine(const T &a, const T &b) { return a + b; }
+    template <typename K>
+    static T lift(const K &, const T &value) { return value; }
+    static T addAll(const T &agg, const T &delta, size_t count) { return agg + delta * (T)count; }
+    static T assignAll(const T &value, size_t count) { return value * (T)count; }
+};
+
+template <typename T>
+struct MinMonoid
+{
+    typedef T value_type;
+    static T identity() { return std::numeric_limits<T>::max(); }
+    static T combine(const T &a, const T &b) { return (b < a) ? b : a; }
+    template <typename K>
+    static T lift(const K &, const T &value) { return value; }
+    static T addAll(const T &agg, const T &delta, size_t) { return agg + delta; }
+    static T assignAll(const T &value, size_t) { return value; }
+};
+
+template <typename T>
+struct MaxMonoid
+{
+    typedef T value_type;
+    static T identity() { return std::numeric_limits<T>::lowest(); }
+    static T combine(const T &a, const T &b) { return (a < b) ? b : a; }
+    template <typename K>
+    static T lift(const K &, const T &value) { return value; }
+    static T addAll(const T &agg, const T &delta, size_t) { return agg + delta; }
+    static T assignAll(const T &value, size_t) { return value; }
+};
+
+/**
+ * An AVLNode that also stores the aggregate of every item in its subtree.
+ */
+template <typename Key, typename Value, typename Agg>
+class AugAVLNode : public AVLNode<Key, Value>
+{
+public:
+    // Constructor/destructor.
+    AugAVLNode(const Key &key, const Value &value, AugAVLNode<Key, Value, Agg> *parent);
+    virtual ~AugAVLNode();
+
+    // Getter/setter for the subtree aggregate.
+    const Agg &getAggregate() const;
+    void setAggregate(const Agg &agg);
+
+    // Getters for parent, left, and right, returning AugAVLNodes.
+    virtual AugAVLNode<Key, Value, Agg> *getParent() const override;
+    virtual AugAVLNode<Key, Value, Agg> *getLeft() const override;
+    virtual AugAVLNode<Key, Value, Agg> *getRight() const override;
+
+protected:
+    Agg agg_;
+};
+
+/*
+  ---------------------------------------------------
+  Begin implementations for the AugAVLNode class.
+  ---------------------------------------------------
+*/
+
+/**
+ * An explicit constructor; the aggregate is filled in by the tree.
+ */
+template <typename Key, typename Value, typename Agg>
+AugAVLNode<Key, Value, Agg>::AugAVLNode(const Key &key, const Value &value, AugAVLNode<Key, Value, Agg> *parent)
+    : AVLNode<Key, Value>(key, value, parent), agg_()
+{
+}
+
+/**
+ * A destructor which does nothing.
+ */
+template <typename Key, typename Value, typename Agg>
+AugAVLNode<Key, Value, Agg>::~AugAVLNode()
+{
+}
+
+/**
+ * A getter for the subtree aggregate.
+ */
+template <typename Key, typename Value, typename Agg>
+const Agg &AugAVLNode<Key, Value, Agg>::getAggregate() const
+{
+    return agg_;
+}
+
+/**
+ * A setter for the subtree aggregate.
+ */
+template <typename Key, typename Value, typename Agg>
+void AugAVLNode<Key, Value, Agg>::setAggregate(const Agg &agg)
+{
+    agg_ = agg;
+}
+
+/**
+ * Overridden so that a static_cast makes the parent an AugAVLNode.
+ */
+template <typename Key, typename Value, typename Agg>
+AugAVLNode<Key, Value, Agg> *AugAVLNode<Key, Value, Agg>::getParent() const
+{
+    return static_cast<AugAVLNode<Key, Value, Agg> *>(this->parent_);
+}
+
+/**
+ * Overridden for the same reasons as above.
+ */
+template <typename Key, typename Value, typename Agg>
+AugAVLNode<Key, Value, Agg> *AugAVLNode<Key, Value, Agg>::getLeft() const
+{
+    return static_cast<AugAVLNode<Key, Value, Agg> *>(this->left_);
+}
+
+/**
+ * Overridden for the same reasons as above.
+ */
+template <typename Key, typename Value, typename Agg>
+AugAVLNode<Key, Value, Agg> *AugAVLNode<Key, Value, Agg>::getRight() const
+{
+    return static_cast<AugAVLNode<Key, Value, Agg> *>(this->right_);
+}
+
+/*
+  -------------------------------------------------
+  End implementations for the AugAVLNode class.
+  -------------------------------------------------
+*/
+
+/**
+ * An AVL tree in which every node keeps Monoid's aggregate of its subtree,
+ * so that the aggregate over any key range is answered in O(log n) instead
+ * of by scanning the range. The aggregate is recomputed along the update
+ * path of every insert and remove and for the two nodes of every rotation,
+ * which keeps updates O(log n).
+ *
+ * Values must only be changed through insert(), insert_near(), upsert() or
+ * modify(), which refresh the aggregates; writing through an iterator or
+ * operator[] leaves them stale.
+ */
+template <class Key, class Value, class Monoid = SumMonoid<Value> >
+class AugmentedAVLTree : public AVLTree<Key, Value>
+{
+public:
+    typedef typename Monoid::value_type Aggregate;
+
+    AugmentedAVLTree();
+    explicit AugmentedAVLTree(NodeResource *resource);
+    virtual ~AugmentedAVLTree();
+
+    Aggregate aggregate(const Key &lo, const Key &hi) const;
+    Aggregate aggregateAll() const;
+
+protected:
+    typedef AugAVLNode<Key, Value, Aggregate> NodeType;
+
+    virtual void nodeSwap(AVLNode<Key, Value> *n1, AVLNode<Key, Value> *n2);
+    virtual void valueChanged(Node<Key, Value> *n);
+    virtual AVLNode<Key, Value> *newNode(const Key &key, const Value &value, AVLNode<Key, Value> *parent);
+    virtual AVLNode<Key, Value> *copyNode(void *where, AVLNode<Key, Value> *from);
+    virtual void refresh(AVLNode<Key, Value> *n);
+    virtual void updatePath(AVLNode<Key, Value> *n);
+
+    // Helper functions
+    static Aggregate aggregateOf(NodeType *n);
+    static Aggregate liftNode(NodeType *n);
+};
+
+/*
+  -------------------------------------------------------
+  Begin implementations for the AugmentedAVLTree class.
+  -------------------------------------------------------
+*/
+
+template <class Key, class Value, class Monoid>
+AugmentedAVLTree<Key, Value, Monoid>::AugmentedAVLTree()
+{
+}
+
+/**
+ * Constructor for a tree whose nodes are allocated from resource.
+ */
+template <class Key, class Value, class Monoid>
+AugmentedAVLTree<Key, Value, Monoid>::AugmentedAVLTree(NodeResource *resource) : AVLTree<Key, Value>(resource)
+{
+}
+
+/**
+ * Clears the tree here so that destroyNode still sees the full node type.
+ */
+template <class Key, class Value, class Monoid>
+AugmentedAVLTree<Key, Value, Monoid>::~AugmentedAVLTree()
+{
+    this->clear();
+}
+
+/**
+ * Returns the aggregate, in key order, of the items whose keys lie in
+ * [lo, hi] (the identity if there are none). The search first walks down to
+ * the highest node inside the range; from there one path collects whole
+ * subtrees right of lo and the other whole subtrees left of hi.
+ */
+template <class Key, class Value, class Monoid>
+typename AugmentedAVLTree<Key, Value, Monoid>::Aggregate
+AugmentedAVLTree<Key, Value, Monoid>::aggregate(const Key &lo, const Key &hi) const
+{
+    NodeType *c = static_cast<NodeType *>(this->root_);
+    while (c != nullptr && (c->getKey() < lo || hi < c->getKey()))
+    {
+        this->pushOnDescent(c);
+        c = (c->getKey() < lo) ? c->getRight() : c->getLeft();
+    }
+    if (c == nullptr)
+    {
+        return Monoid::identity();
+    }
+    this->pushOnDescent(c);
+
+    // everything at or right of each node >= lo is in range
+    Aggregate left = Monoid::identity();
+    for (NodeType *l = c->getLeft(); l != nullptr;)
+    {
+        this->pushOnDescent(l);
+        if (l->getKey() < lo)
+        {
+            l = l->getRight();
+        }
+        else
+        {
+            left = Monoid::combine(Monoid::combine(liftNode(l), aggregateOf(l->getRight())), left);
+            l = l->getLeft();
+        }
+    }
+
+    // everything at or left of each node <= hi is in range
+    Aggregate right = Monoid::identity();
+    for (NodeType *r = c->getRight(); r != nullptr;)
+    {
+        this->pushOnDescent(r);
+        if (hi < r->getKey())
+        {
+            r = r->getLeft();
+        }
+        else
+        {
+            right = Monoid::combine(right, Monoid::combine(aggregateOf(r->getLeft()), liftNode(r)));
+            r = r->getRight();
+        }
+    }
+    return Monoid::combine(Monoid::combine(left, liftNode(c)), right);
+}
+
+/**
+ * Returns the aggregate of the whole tree in O(1).
+ */
+template <class Key, class Value, class Monoid>
+typename AugmentedAVLTree<Key, Value, Monoid>::Aggregate AugmentedAVLTree<Key, Value, Monoid>::aggregateAll() const
+{
+    return aggregateOf(static_cast<NodeType *>(this->root_));
+}
+
+/**
+ * Swaps two nodes as AVLTree does, and their aggregates with them so each
+ * aggregate stays with its position. remove() refreshes the path afterwards.
+ */
+template <class Key, class Value, class Monoid>
+void AugmentedAVLTree<Key, Value, Monoid>::nodeSwap(AVLNode<Key, Value> *n1, AVLNode<Key, Value> *n2)
+{
+    AVLTree<Key, Value>::nodeSwap(n1, n2);
+    NodeType *a1 = static_cast<NodeType *>(n1);
+    NodeType *a2 = static_cast<NodeType *>(n2);
+    Aggregate temp = a1->getAggregate();
+    a1->setAggregate(a2->getAggregate());
+    a2->setAggregate(temp);
+}
+
+/**
+ * The aggregates from n up to the root include n's old value.
+ */
+template <class Key, class Value, class Monoid>
+void AugmentedAVLTree<Key, Value, Monoid>::valueChanged(Node<Key, Value> *n)
+{
+    updatePath(static_cast<NodeType *>(n));
+}
+
+/**
+ * Allocates an AugAVLNode holding the aggregate of just its own item.
+ */
+template <class Key, class Value, class Monoid>
+AVLNode<Key, Value> *AugmentedAVLTree<Key, Value, Monoid>::newNode(const Key &key, const Value &value,
+                                                                   AVLNode<Key, Value> *parent)
+{
+    NodeType *n = this->createNode(key, value, static_cast<NodeType *>(parent));
+    n->setAggregate(Monoid::lift(key, value));
+    return n;
+}
+
+/**
+ * Copies the aggregate along with the rest of the node for compact().
+ */
+template <class Key, class Value, class Monoid>
+AVLNode<Key, Value> *AugmentedAVLTree<Key, Value, Monoid>::copyNode(void *where, AVLNode<Key, Value> *from)
+{
+    NodeType *f = static_cast<NodeType *>(from);
+    NodeType *n = new (where) NodeType(f->getKey(), f->getValue(), nullptr);
+    n->setBalance(f->getBalance());
+    n->setAggregate(f->getAggregate());
+    return n;
+}
+
+/**
+ * Recomputes the aggregate of n from its children and its own item.
+ */
+template <class Key, class Value, class Monoid>
+void AugmentedAVLTree<Key, Value, Monoid>::refresh(AVLNode<Key, Value> *n)
+{
+    NodeType *a = static_cast<NodeType *>(n);
+    a->setAggregate(Monoid::combine(Monoid::combine(aggregateOf(a->getLeft()), liftNode(a)),
+                                    aggregateOf(a->getRight())));
+}
+
+/**
+ * Refreshes n and every ancestor of it, bottom up.
+ */
+template <class Key, class Value, class Monoid>
+void AugmentedAVLTree<Key, Value, Monoid>::updatePath(AVLNode<Key, Value> *n)
+{
+    for (; n != nullptr; n = n->getParent())
+    {
+        refresh(n);
+    }
+}
+
+/**
+ * The aggregate of the subtree at n, where a missing subtree is the identity.
+ */
+template <class Key, class Value, class Monoid>
+typename AugmentedAVLTree<Key, Value, Monoid>::Aggregate AugmentedAVLTree<Key, Value, Monoid>::aggregateOf(NodeType *n)
+{
+    return (n == nullptr) ? Monoid::identity() : n->getAggregate();
+}
+
+/**
+ * The aggregate of the single item stored in n.
+ */
+template <class Key, class Value, class Monoid>
+typename AugmentedAVLTree<Key, Value, Monoid>::Aggregate AugmentedAVLTree<Key, Value, Monoid>::liftNode(NodeType *n)
+{
+    return Monoid::lift(n->getKey(), n->getValue());
+}
+
+/*
+  -----------------------------------------------------
+  End implementations for the AugmentedAVLTree class.
+  -----------------------------------------------------
+*/
+
+#endif
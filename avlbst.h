@@ -1,13 +1,27 @@
-#ifndef RBBST_H
-#define RBBST_H
+#ifndef AVLBST_H
+#define AVLBST_H
 
 #include <iostream>
 #include <exception>
 #include <cstdlib>
 #include <cstdint>
 #include <algorithm>
+#include <atomic>
+#include <functional>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 #include "bst.h"
 
+// Define AVLBST_VALIDATE (e.g. in debug and canary builds) to have every
+// AVLTree run validate() after a number of inserts and removes equal to its
+// size, so the checks cost O(1) amortized per update, and throw
+// std::logic_error once an invariant is broken.
+#ifndef AVLBST_VALIDATE_THREADS
+#define AVLBST_VALIDATE_THREADS 1
+#endif
+
 struct KeyError
 {
 };
@@ -129,18 +143,88 @@ template <class Key, class Value>
 class AVLTree : public BinarySearchTree<Key, Value>
 {
 public:
+    AVLTree();
+    explicit AVLTree(NodeResource *resource);
+    virtual ~AVLTree();
     virtual void insert(const std::pair<const Key, Value> &new_item); // TODO
-    virtual void remove(const Key &key);                              // TODO
+    void compact();
+    bool validate(unsigned threads = 1) const;
+
 protected:
     virtual void nodeSwap(AVLNode<Key, Value> *n1, AVLNode<Key, Value> *n2);
+    virtual void removeNode(Node<Key, Value> *node);
+    virtual bool relinkable() const;
+    virtual void destroyNode(Node<Key, Value> *n);
+    virtual Node<Key, Value> *attachLeaf(Node<Key, Value> *parent, const std::pair<const Key, Value> &new_item);
+
+    // Hooks for trees that keep extra per-node data derived from the subtree
+    // below each node (see AugmentedAVLTree); the AVL tree itself keeps none.
+    virtual AVLNode<Key, Value> *newNode(const Key &key, const Value &value, AVLNode<Key, Value> *parent);
+    virtual AVLNode<Key, Value> *copyNode(void *where, AVLNode<Key, Value> *from);
+    virtual void refresh(AVLNode<Key, Value> *n);
+    virtual void updatePath(AVLNode<Key, Value> *n);
+    virtual void pushDown(AVLNode<Key, Value> *n);
 
     // Add helper functions here
     void removeFix(AVLNode<Key, Value> *p, int8_t diff);
     void insertFix(AVLNode<Key, Value> *p, AVLNode<Key, Value> *n);
     void rotateLeft(AVLNode<Key, Value> *p);
     void rotateRight(AVLNode<Key, Value> *p);
+    static int subtreeHeight(Node<Key, Value> *r);
+    static void vebOrder(Node<Key, Value> *r, int height, std::vector<Node<Key, Value> *> &order);
+    static void collectAtDepth(Node<Key, Value> *r, int depth, std::vector<Node<Key, Value> *> &out);
+
+    // A subtree for validate() to check, with the nearest ancestors bounding
+    // its keys from below and above (null where there is none)
+    struct CheckFrame
+    {
+        AVLNode<Key, Value> *node;
+        AVLNode<Key, Value> *lo;
+        AVLNode<Key, Value> *hi;
+    };
+    int validateSubtree(const CheckFrame &top, int cutDepth, const int *cutHeights, size_t &count) const;
+    bool inBounds(const CheckFrame &f) const;
+    void validateAfterUpdate();
+
+    // Block holding the nodes placed by the last compact(); nodes inserted
+    // afterwards are allocated individually as usual.
+    char *arena_;
+    size_t arenaBytes_;
+    size_t arenaLive_;
+
+    // inserts and removes since the last validate() under AVLBST_VALIDATE
+    size_t updatesSinceValidate_;
 };
 
+/**
+ * Default constructor, which starts without a compaction block.
+ */
+template <class Key, class Value>
+AVLTree<Key, Value>::AVLTree() : arena_(nullptr), arenaBytes_(0), arenaLive_(0), updatesSinceValidate_(0)
+{
+}
+
+/**
+ * Constructor for a tree whose nodes (and compaction block) are allocated
+ * from resource, which must outlive the tree.
+ */
+template <class Key, class Value>
+AVLTree<Key, Value>::AVLTree(NodeResource *resource)
+    : BinarySearchTree<Key, Value>(resource), arena_(nullptr), arenaBytes_(0), arenaLive_(0),
+      updatesSinceValidate_(0)
+{
+}
+
+/**
+ * Clears the tree here so that destroyNode still dispatches to the AVLTree
+ * version, which knows about the compaction block.
+ */
+template <class Key, class Value>
+AVLTree<Key, Value>::~AVLTree()
+{
+    this->clear();
+}
+
 /*
  * Recall: If key is already in the tree, you should
  * overwrite the current value with the updated value.
@@ -148,104 +232,81 @@ protected:
 template <class Key, class Value>
 void AVLTree<Key, Value>::insert(const std::pair<const Key, Value> &new_item)
 {
-    if (this->root_ == nullptr)
-    {
-        // if it is, then we add new node
-        AVLNode<Key, Value> *n = new AVLNode<Key, Value>(new_item.first, new_item.second, nullptr);
-        this->root_ = n;
-        n->setBalance(0);
-        return;
-    }
-    else
-    {
-        // creating temp node
-        AVLNode<Key, Value> *c = static_cast<AVLNode<Key, Value> *>(this->root_);
+    AVLNode<Key, Value> *parent = nullptr;
+    AVLNode<Key, Value> *c = static_cast<AVLNode<Key, Value> *>(this->root_);
 
-        // iterating through while true
-        while (true)
+    // walking down to the insertion point
+    while (c != nullptr)
+    {
+        this->pushOnDescent(c);
+        parent = c;
+        if (new_item.first < c->getKey())
         {
-            // checking if c key is greater
-            if (new_item.first < c->getKey())
-            {
-                // if c getLeft is nullptr, then we add a new node
-                if (c->getLeft() == nullptr)
-                {
-                    AVLNode<Key, Value> *ins2 = new AVLNode<Key, Value>(new_item.first, new_item.second, c);
-                    c->setLeft(ins2);
-                    ins2->setBalance(0);
-                    if (c->getBalance() == 1 || c->getBalance() == -1)
-                    {
-                        c->setBalance(0);
-                    }
-                    else if (c->getBalance() == 0)
-                    {
-                        c->updateBalance(-1);
-                        insertFix(c, ins2);
-                    }
-                    break;
-                }
-                // if not then we iterate to next left
-                else
-                {
-                    c = c->getLeft();
-                }
-            }
-            // checking if c key is less
-            else if (new_item.first > c->getKey())
-            {
-                // if c getRight is nullptr, then we add a new node
-                if (c->getRight() == nullptr)
-                {
-                    AVLNode<Key, Value> *ins = new AVLNode<Key, Value>(new_item.first, new_item.second, c);
-                    ins->setBalance(0);
-                    c->setRight(ins);
-                    if (c->getBalance() == 1 || c->getBalance() == -1)
-                    {
-                        c->setBalance(0);
-                    }
-                    else if (c->getBalance() == 0)
-                    {
-                        c->updateBalance(1);
-                        insertFix(c, ins);
-                    }
-                    break;
-                }
-                // if not then we iterate to next left
-                else
-                {
-                    c = c->getRight();
-                }
-            }
-            else // both of them are the same
-            {
-                c->setValue(new_item.second);
-                break;
-            }
+            c = c->getLeft();
+        }
+        else if (new_item.first > c->getKey())
+        {
+            c = c->getRight();
+        }
+        else // both of them are the same
+        {
+            c->setValue(new_item.second);
+            this->valueChanged(c);
+            return;
         }
     }
+    attachLeaf(parent, new_item);
 }
 
-/*
- * Recall: The writeup specifies that if a node has 2 children you
- * should swap with the predecessor and then remove.
+/**
+ * Links a new AVLNode under parent and updates the balances above it.
  */
 template <class Key, class Value>
-void AVLTree<Key, Value>::remove(const Key &key)
+Node<Key, Value> *AVLTree<Key, Value>::attachLeaf(Node<Key, Value> *parent,
+                                                  const std::pair<const Key, Value> &new_item)
 {
-    // root check
-    if (this->root_ == nullptr)
+    AVLNode<Key, Value> *c = static_cast<AVLNode<Key, Value> *>(parent);
+    AVLNode<Key, Value> *n = newNode(new_item.first, new_item.second, c);
+    n->setBalance(0);
+    if (c == nullptr)
     {
-        return;
+        this->root_ = n;
+        this->noteLinked(n);
+        return n;
     }
 
-    // finding the node
-    AVLNode<Key, Value> *n = static_cast<AVLNode<Key, Value> *>(this->internalFind(key));
-
-    // if n is nullptr then we return
-    if (n == nullptr)
+    int8_t diff = (new_item.first < c->getKey()) ? -1 : 1;
+    if (diff < 0)
     {
-        return;
+        c->setLeft(n);
+    }
+    else
+    {
+        c->setRight(n);
+    }
+    this->noteLinked(n);
+    updatePath(c);
+    if (c->getBalance() == 1 || c->getBalance() == -1)
+    {
+        c->setBalance(0);
+    }
+    else if (c->getBalance() == 0)
+    {
+        c->updateBalance(diff);
+        insertFix(c, n);
     }
+    validateAfterUpdate();
+    return n;
+}
+
+/*
+ * Recall: The writeup specifies that if a node has 2 children you
+ * should swap with the predecessor and then remove.
+ */
+template <class Key, class Value>
+void AVLTree<Key, Value>::removeNode(Node<Key, Value> *node)
+{
+    AVLNode<Key, Value> *n = static_cast<AVLNode<Key, Value> *>(node);
 
     // case for when there are 2 children
     // having this first bc after swap we will either be in a 0-child or 1-child case
@@ -290,6 +351,7 @@ void AVLTree<Key, Value>::remove(const Key &key)
     }
 
     // updating the parent node to complete the promote functionality
+    this->noteUnlinking(n);
     AVLNode<Key, Value> *two = n->getParent();
     if (two == nullptr)
     {
@@ -313,9 +375,11 @@ void AVLTree<Key, Value>::remove(const Key &key)
         one->setParent(two);
     }
     // deleting c
-    delete n;
+    this->destroyNode(n);
 
+    updatePath(p);
     removeFix(p, diff);
+    validateAfterUpdate();
 }
 
 template <class Key, class Value>
@@ -584,7 +648,8 @@ void AVLTree<Key, Value>::rotateRight(AVLNode<Key, Value> *n)
     {
         return;
     }
-
+    pushDown(n);
+    pushDown(l);
 
     // rotation 
     n->setLeft(l->getRight());
@@ -610,6 +675,8 @@ void AVLTree<Key, Value>::rotateRight(AVLNode<Key, Value> *n)
     }
     n->setParent(l);
     l->setRight(n);
+    refresh(n);
+    refresh(l);
     return;
 }
 
@@ -628,7 +695,8 @@ void AVLTree<Key, Value>::rotateLeft(AVLNode<Key, Value> *n)
     {
         return;
     }
-
+    pushDown(n);
+    pushDown(r);
     // rotation 
     n->setRight(r->getLeft());
 
@@ -655,7 +723,470 @@ void AVLTree<Key, Value>::rotateLeft(AVLNode<Key, Value> *n)
 
     n->setParent(r);
     r->setLeft(n);
+    refresh(n);
+    refresh(r);
     return;
 }
 
+/**
+ * Frees a node, which may live in the compaction block. The block itself is
+ * released once the last node placed in it is gone.
+ */
+template <class Key, class Value>
+void AVLTree<Key, Value>::destroyNode(Node<Key, Value> *n)
+{
+    char *a = static_cast<char *>(static_cast<void *>(n));
+    std::less<const char *> before;
+    if (arena_ != nullptr && !before(a, arena_) && before(a, arena_ + arenaBytes_))
+    {
+        n->~Node<Key, Value>();
+        --this->usage_.liveNodes;
+        if (--arenaLive_ == 0)
+        {
+            this->releaseBytes(arena_, arenaBytes_, this->nodeAlign_);
+            arena_ = nullptr;
+            arenaBytes_ = 0;
+        }
+        return;
+    }
+    BinarySearchTree<Key, Value>::destroyNode(n);
+}
+
+/**
+ * Relocates every node into one contiguous block laid out in van Emde Boas
+ * order: the top half of the tree's levels first, then each bottom subtree,
+ * each recursively laid out the same way. A search then touches O(log_B n)
+ * blocks of any size B instead of one cache line per level, whatever the
+ * allocation history of the tree. Keys, values, balances and shape are
+ * unchanged and the tree stays fully mutable afterwards, but iterators and
+ * references into the tree are invalidated.
+ */
+template <class Key, class Value>
+void AVLTree<Key, Value>::compact()
+{
+    if (this->root_ == nullptr)
+    {
+        return;
+    }
+
+    std::vector<Node<Key, Value> *> order;
+    vebOrder(this->root_, subtreeHeight(this->root_), order);
+
+    // every node of the tree has the size recorded when it was created
+    size_t stride = this->usage_.nodeBytes;
+    size_t bytes = order.size() * stride;
+    char *block = static_cast<char *>(this->allocateBytes(bytes, this->nodeAlign_));
+    std::vector<AVLNode<Key, Value> *> copies(order.size());
+    size_t built = 0;
+    try
+    {
+        for (; built < order.size(); ++built)
+        {
+            copies[built] = copyNode(block + built * stride, static_cast<AVLNode<Key, Value> *>(order[built]));
+        }
+    }
+    catch (...)
+    {
+        while (built > 0)
+        {
+            copies[--built]->~AVLNode<Key, Value>();
+        }
+        this->releaseBytes(block, bytes, this->nodeAlign_);
+        throw;
+    }
+
+    // the old nodes' parent links are no longer needed (the new ones are
+    // rebuilt from the child links), so they temporarily point at the copies
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        order[i]->setParent(copies[i]);
+    }
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        Node<Key, Value> *l = order[i]->getLeft();
+        Node<Key, Value> *r = order[i]->getRight();
+        if (l != nullptr)
+        {
+            copies[i]->setLeft(l->getParent());
+            l->getParent()->setParent(copies[i]);
+        }
+        if (r != nullptr)
+        {
+            copies[i]->setRight(r->getParent());
+            r->getParent()->setParent(copies[i]);
+        }
+    }
+
+    this->usage_.liveNodes += order.size();
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        destroyNode(order[i]);
+    }
+    arena_ = block;
+    arenaBytes_ = bytes;
+    arenaLive_ = order.size();
+    this->root_ = copies[0];
+    this->findExtremes();
+}
+
+/**
+ * Checks every AVL invariant in one O(n) pass with explicit stacks: keys
+ * are ordered within the bounds set by their ancestors, child and parent
+ * links agree, each stored balance equals the difference of the real
+ * subtree heights and is within [-1, 1], and the tree holds exactly as many
+ * nodes as were allocated for it (so a cycle or a node linked twice is
+ * caught rather than walked forever). With more than one thread (0 picks
+ * the hardware concurrency), the subtrees a few levels below the root are
+ * checked concurrently and the levels above them last. Returns false at the
+ * first violation. Does not modify the tree, but must not run concurrently
+ * with updates.
+ */
+template <class Key, class Value>
+bool AVLTree<Key, Value>::validate(unsigned threads) const
+{
+    AVLNode<Key, Value> *root = static_cast<AVLNode<Key, Value> *>(this->root_);
+    size_t limit = this->usage_.liveNodes;
+    if (root == nullptr)
+    {
+        return limit == 0;
+    }
+    if (root->getParent() != nullptr)
+    {
+        return false;
+    }
+    if (threads == 0)
+    {
+        threads = std::thread::hardware_concurrency();
+    }
+
+    CheckFrame top = {root, nullptr, nullptr};
+    size_t count = 0;
+    if (threads <= 1)
+    {
+        return validateSubtree(top, -1, nullptr, count) >= 0 && count == limit;
+    }
+
+    // split off enough subtrees, all at the same depth, to keep every thread
+    // busy; each keeps the bounds its ancestors put on its keys
+    std::vector<CheckFrame> cuts(1, top);
+    size_t target = 8 * (size_t)threads;
+    int cutDepth = 0;
+    while (!cuts.empty() && cuts.size() < target && cutDepth < 32)
+    {
+        std::vector<CheckFrame> next;
+        for (size_t i = 0; i < cuts.size(); ++i)
+        {
+            CheckFrame f = cuts[i];
+            if (f.node->getLeft() != nullptr)
+            {
+                CheckFrame l = {f.node->getLeft(), f.lo, f.node};
+                next.push_back(l);
+            }
+            if (f.node->getRight() != nullptr)
+            {
+                CheckFrame r = {f.node->getRight(), f.node, f.hi};
+                next.push_back(r);
+            }
+        }
+        cuts.swap(next);
+        ++cutDepth;
+    }
+    if (cuts.size() <= 1)
+    {
+        return validateSubtree(top, -1, nullptr, count) >= 0 && count == limit;
+    }
+
+    std::vector<int> heights(cuts.size(), -1);
+    std::vector<size_t> counts(cuts.size(), 0);
+    std::atomic<size_t> nextCut(0);
+    std::atomic<bool> failed(false);
+    auto worker = [&]() {
+        size_t i;
+        while (!failed.load(std::memory_order_relaxed) && (i = nextCut.fetch_add(1)) < cuts.size())
+        {
+            heights[i] = validateSubtree(cuts[i], -1, nullptr, counts[i]);
+            if (heights[i] < 0)
+            {
+                failed.store(true);
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < std::min<size_t>(threads, cuts.size()); ++t)
+    {
+        pool.push_back(std::thread(worker));
+    }
+    worker();
+    for (size_t t = 0; t < pool.size(); ++t)
+    {
+        pool[t].join();
+    }
+    if (failed.load())
+    {
+        return false;
+    }
+
+    // the levels above the cuts, taking the cut subtrees' heights as found
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+        count += counts[i];
+    }
+    return validateSubtree(top, cutDepth, &heights[0], count) >= 0 && count == limit;
+}
+
+/**
+ * Checks the subtree top.node by an iterative post-order walk and returns
+ * its height, or -1 on the first broken invariant. Every node walked is
+ * added to count; the walk gives up once count exceeds the tree's node
+ * count. If cutHeights is not null, the nodes cutDepth levels below
+ * top.node are not entered (they were checked separately) and take their
+ * heights from cutHeights, in left to right order.
+ */
+template <class Key, class Value>
+int AVLTree<Key, Value>::validateSubtree(const CheckFrame &top, int cutDepth, const int *cutHeights,
+                                         size_t &count) const
+{
+    struct Step
+    {
+        CheckFrame frame;
+        int depth;
+        bool entered;
+    };
+    std::vector<Step> stack;
+    std::vector<int> heights;
+    Step first = {top, 0, false};
+    stack.push_back(first);
+    while (!stack.empty())
+    {
+        Step &s = stack.back();
+        AVLNode<Key, Value> *n = s.frame.node;
+        AVLNode<Key, Value> *l = n->getLeft();
+        AVLNode<Key, Value> *r = n->getRight();
+        if (cutHeights != nullptr && s.depth == cutDepth)
+        {
+            heights.push_back(*cutHeights++);
+            stack.pop_back();
+            continue;
+        }
+        if (!s.entered)
+        {
+            if (++count > this->usage_.liveNodes || !inBounds(s.frame))
+            {
+                return -1;
+            }
+            if ((l != nullptr && l->getParent() != n) || (r != nullptr && r->getParent() != n))
+            {
+                return -1;
+            }
+            s.entered = true;
+            Step right = {{r, n, s.frame.hi}, s.depth + 1, false};
+            Step left = {{l, s.frame.lo, n}, s.depth + 1, false};
+            // s is invalidated by the pushes; the left child is walked first
+            if (r != nullptr)
+            {
+                stack.push_back(right);
+            }
+            if (l != nullptr)
+            {
+                stack.push_back(left);
+            }
+            continue;
+        }
+
+        // both children are done, and their heights are on top, right last
+        int rh = 0;
+        int lh = 0;
+        if (r != nullptr)
+        {
+            rh = heights.back();
+            heights.pop_back();
+        }
+        if (l != nullptr)
+        {
+            lh = heights.back();
+            heights.pop_back();
+        }
+        if (n->getBalance() != rh - lh || n->getBalance() < -1 || n->getBalance() > 1)
+        {
+            return -1;
+        }
+        heights.push_back(1 + std::max(lh, rh));
+        stack.pop_back();
+    }
+    return heights.back();
+}
+
+/**
+ * Returns true if f.node's key lies between the keys of f.lo and f.hi,
+ * strictly unless the tree keeps duplicate keys.
+ */
+template <class Key, class Value>
+bool AVLTree<Key, Value>::inBounds(const CheckFrame &f) const
+{
+    const Key &k = f.node->getKey();
+    if (this->keysUnique())
+    {
+        return (f.lo == nullptr || f.lo->getKey() < k) && (f.hi == nullptr || k < f.hi->getKey());
+    }
+    return (f.lo == nullptr || !(k < f.lo->getKey())) && (f.hi == nullptr || !(f.hi->getKey() < k));
+}
+
+/**
+ * Under AVLBST_VALIDATE, runs validate() once the updates since the last
+ * run reach the tree's size and throws std::logic_error if it fails.
+ * Otherwise does nothing.
+ */
+template <class Key, class Value>
+void AVLTree<Key, Value>::validateAfterUpdate()
+{
+#ifdef AVLBST_VALIDATE
+    if (++updatesSinceValidate_ < std::max<size_t>(this->usage_.liveNodes, 64))
+    {
+        return;
+    }
+    updatesSinceValidate_ = 0;
+    if (!validate(AVLBST_VALIDATE_THREADS))
+    {
+        throw std::logic_error("AVLTree invariants violated");
+    }
+#endif
+}
+
+/**
+ * Allocates a node for a new item. Overridden by trees with larger nodes.
+ */
+template <class Key, class Value>
+AVLNode<Key, Value> *AVLTree<Key, Value>::newNode(const Key &key, const Value &value, AVLNode<Key, Value> *parent)
+{
+    return this->createNode(key, value, parent);
+}
+
+/**
+ * Constructs a copy of from (without links) at where, for compact().
+ */
+template <class Key, class Value>
+AVLNode<Key, Value> *AVLTree<Key, Value>::copyNode(void *where, AVLNode<Key, Value> *from)
+{
+    AVLNode<Key, Value> *n = new (where) AVLNode<Key, Value>(from->getKey(), from->getValue(), nullptr);
+    n->setBalance(from->getBalance());
+    return n;
+}
+
+/**
+ * Recomputes the derived data of n from its children after they changed
+ * (e.g. in a rotation). Nothing to do for a plain AVL tree.
+ */
+template <class Key, class Value>
+void AVLTree<Key, Value>::refresh(AVLNode<Key, Value> *n)
+{
+    (void)n;
+}
+
+/**
+ * Calls refresh on n and each of its ancestors, after an insert or remove
+ * below n and before any rotations. Nothing to do for a plain AVL tree.
+ */
+template <class Key, class Value>
+void AVLTree<Key, Value>::updatePath(AVLNode<Key, Value> *n)
+{
+    (void)n;
+}
+
+/**
+ * A DSW rebuild would leave the balances in the nodes stale, and the tree keeps
+ * itself balanced anyway, so rebalance() and setAutoRebalance() refuse.
+ */
+template <class Key, class Value>
+bool AVLTree<Key, Value>::relinkable() const
+{
+    return false;
+}
+
+/**
+ * Hands any update still pending at n down to its children, before a
+ * rotation changes which subtrees lie below n. Nothing to do for a plain
+ * AVL tree.
+ */
+template <class Key, class Value>
+void AVLTree<Key, Value>::pushDown(AVLNode<Key, Value> *n)
+{
+    (void)n;
+}
+
+/**
+ * Returns the number of levels in the subtree at r, using an explicit stack.
+ */
+template <class Key, class Value>
+int AVLTree<Key, Value>::subtreeHeight(Node<Key, Value> *r)
+{
+    int height = 0;
+    std::vector<std::pair<Node<Key, Value> *, int> > stack;
+    if (r != nullptr)
+    {
+        stack.push_back(std::make_pair(r, 1));
+    }
+    while (!stack.empty())
+    {
+        Node<Key, Value> *c = stack.back().first;
+        int depth = stack.back().second;
+        stack.pop_back();
+        height = std::max(height, depth);
+        if (c->getLeft() != nullptr)
+        {
+            stack.push_back(std::make_pair(c->getLeft(), depth + 1));
+        }
+        if (c->getRight() != nullptr)
+        {
+            stack.push_back(std::make_pair(c->getRight(), depth + 1));
+        }
+    }
+    return height;
+}
+
+/**
+ * Appends the nodes of the subtree at r that lie in its first `height`
+ * levels to order, in van Emde Boas order.
+ */
+template <class Key, class Value>
+void AVLTree<Key, Value>::vebOrder(Node<Key, Value> *r, int height, std::vector<Node<Key, Value> *> &order)
+{
+    if (r == nullptr || height <= 0)
+    {
+        return;
+    }
+    if (height == 1)
+    {
+        order.push_back(r);
+        return;
+    }
+    int top = height - height / 2;
+    vebOrder(r, top, order);
+
+    std::vector<Node<Key, Value> *> bottoms;
+    collectAtDepth(r, top, bottoms);
+    for (size_t i = 0; i < bottoms.size(); ++i)
+    {
+        vebOrder(bottoms[i], height - top, order);
+    }
+}
+
+/**
+ * Appends the nodes exactly `depth` levels below r to out, left to right.
+ */
+template <class Key, class Value>
+void AVLTree<Key, Value>::collectAtDepth(Node<Key, Value> *r, int depth, std::vector<Node<Key, Value> *> &out)
+{
+    if (r == nullptr)
+    {
+        return;
+    }
+    if (depth == 0)
+    {
+        out.push_back(r);
+        return;
+    }
+    collectAtDepth(r->getLeft(), depth - 1, out);
+    collectAtDepth(r->getRight(), depth - 1, out);
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,1629 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#include "bst.h"
+#include "avlbst.h"
+#include "rbbst.h"
+#include "splaybst.h"
+#include "wavlbst.h"
+#include "scapegoatbst.h"
+#include "indexavlbst.h"
+#include "staticavlbst.h"
+#include "smallavlbst.h"
+#include "trace_bst.h"
+#include "augavlbst.h"
+#include "lazyavlbst.h"
+#include "intervalbst.h"
+#include "latency_histogram.h"
+
+using namespace std;
+
+/**
+ * Benchmark driver for the search trees. Every insert, remove, find and
+ * iterator increment is timed individually into a LatencyHistogram so that
+ * the tail (p99, p99.9, max) is visible and not just the average.
+ *
+ * Usage:
+ *   bst-bench [-n N] [-seed S] [-workload W] [-tree T] [-save FILE]
+ *   bst-bench -compare BASELINE.txt CANDIDATE.txt
+ *   bst-bench -memory [-n N]
+ *   bst-bench -batch [-n N]
+ *   bst-bench -compact [-n N]
+ *   bst-bench -finger [-n N]
+ *   bst-bench -aggregate [-n N]
+ *   bst-bench -lazy [-n N]
+ *   bst-bench -interval [-n N]
+ *   bst-bench -validate [-n N] [-threads T]
+ *   bst-bench -profile [-n N] [-workload sorted|random] [-tree T] [-save FILE]
+ *   bst-bench -export dot|ndjson [-n N] [-save FILE]
+ *   bst-bench -rebalance [-n N]
+ *   bst-bench -popmin [-n N]
+ *   bst-bench -iterate [-n N]
+ *   bst-bench -static [-n N]
+ *   bst-bench -small [-n N]
+ *   bst-bench -record FILE [-n N] [-workload W]
+ */
+
+// Volatile sink so the optimizer cannot drop lookups whose result is unused.
+static volatile long benchSink = 0;
+
+// Tree-specific observations (e.g. rebalancing counters) printed after the table.
+static vector<string> benchNotes;
+
+/**
+ * The key sequences that make up one workload.
+ */
+struct Workload
+{
+    string name;
+    vector<int> inserts;
+    vector<int> finds;
+    vector<int> removes;
+    // When true, every remove is immediately followed by an insert of the
+    // matching entry in `inserts` past the initial fill (steady-state churn).
+    bool churn;
+};
+
+/**
+ * Per-operation latency histograms (recorded in clock ticks).
+ */
+struct OpStats
+{
+    LatencyHistogram insert;
+    LatencyHistogram remove;
+    LatencyHistogram find;
+    LatencyHistogram next;
+};
+
+/**
+ * One summarized row of output: a workload/tree/operation triple.
+ */
+struct ResultRow
+{
+    string workload;
+    string tree;
+    string op;
+    uint64_t count;
+    double mean;
+    double p50;
+    double p99;
+    double p999;
+    double max;
+};
+
+static unsigned long long rngState = 88172645463325252ULL;
+
+static unsigned long long nextRandom()
+{
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return rngState;
+}
+
+static void shuffleKeys(vector<int> &keys)
+{
+    for (size_t i = keys.size(); i > 1; --i)
+    {
+        size_t j = (size_t)(nextRandom() % i);
+        swap(keys[i - 1], keys[j]);
+    }
+}
+
+static vector<int> sequentialKeys(int n)
+{
+    vector<int> keys((size_t)n);
+    for (int i = 0; i < n; ++i)
+    {
+        keys[(size_t)i] = i;
+    }
+    return keys;
+}
+
+/**
+ * Draws `count` keys from 0..n-1 with Zipf(s) popularity. The popularity rank
+ * is mapped to keys through a random permutation so hot keys are spread over
+ * the key space instead of clustering at the smallest keys.
+ */
+static vector<int> zipfKeys(int n, size_t count, double s)
+{
+    vector<double> cdf((size_t)n);
+    double total = 0.0;
+    for (int i = 0; i < n; ++i)
+    {
+        total += 1.0 / pow((double)(i + 1), s);
+        cdf[(size_t)i] = total;
+    }
+    vector<int> byRank = sequentialKeys(n);
+    shuffleKeys(byRank);
+
+    vector<int> keys(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        double u = (double)(nextRandom() >> 11) / 9007199254740992.0 * total;
+        size_t rank = (size_t)(lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin());
+        keys[i] = byRank[min(rank, (size_t)n - 1)];
+    }
+    return keys;
+}
+
+static Workload makeWorkload(const string &name, int n)
+{
+    Workload w;
+    w.name = name;
+    w.churn = false;
+    if (name == "sorted")
+    {
+        w.inserts = sequentialKeys(n);
+        w.finds = sequentialKeys(n);
+        w.removes = sequentialKeys(n);
+    }
+    else if (name == "random")
+    {
+        w.inserts = sequentialKeys(n);
+        shuffleKeys(w.inserts);
+        w.finds = sequentialKeys(n);
+        shuffleKeys(w.finds);
+        w.removes = sequentialKeys(n);
+        shuffleKeys(w.removes);
+    }
+    else if (name == "zipf")
+    {
+        // skewed lookups: with s = 1.1 roughly 80% of finds hit the hottest 1% of keys
+        w.inserts = sequentialKeys(n);
+        shuffleKeys(w.inserts);
+        w.finds = zipfKeys(n, 4 * (size_t)n, 1.1);
+        w.removes = sequentialKeys(n);
+        shuffleKeys(w.removes);
+    }
+    else if (name == "churn")
+    {
+        // fill with n keys, then remove a random live key and insert a fresh
+        // one n times, so the tree stays at size n while every node turns over
+        w.inserts = sequentialKeys(2 * n);
+        shuffleKeys(w.inserts);
+        w.removes.assign(w.inserts.begin(), w.inserts.begin() + n);
+        shuffleKeys(w.removes);
+        w.finds.assign(w.inserts.begin() + n, w.inserts.end());
+        shuffleKeys(w.finds);
+        w.churn = true;
+    }
+    return w;
+}
+
+template <class Tree>
+static void timedInsert(Tree &tree, int key, OpStats &stats)
+{
+    uint64_t start = LatencyClock::now();
+    tree.insert(std::make_pair(key, key));
+    stats.insert.record(LatencyClock::now() - start);
+}
+
+template <class Tree>
+static void timedRemove(Tree &tree, int key, OpStats &stats)
+{
+    uint64_t start = LatencyClock::now();
+    tree.remove(key);
+    stats.remove.record(LatencyClock::now() - start);
+}
+
+template <class Tree>
+static void timedFind(Tree &tree, int key, OpStats &stats)
+{
+    uint64_t start = LatencyClock::now();
+    typename Tree::iterator it = tree.find(key);
+    stats.find.record(LatencyClock::now() - start);
+    if (it != tree.end())
+    {
+        benchSink += it->second;
+    }
+}
+
+template <class Tree>
+static void timedIterate(Tree &tree, OpStats &stats)
+{
+    typename Tree::iterator it = tree.begin();
+    while (it != tree.end())
+    {
+        benchSink += it->first;
+        uint64_t start = LatencyClock::now();
+        ++it;
+        stats.next.record(LatencyClock::now() - start);
+    }
+}
+
+/**
+ * Records tree-specific counters once a workload has finished. Trees without
+ * counters have nothing to report.
+ */
+template <class Tree>
+static void noteTreeStats(const string &, const string &, const Tree &)
+{
+}
+
+static void noteTreeStats(const string &workload, const string &name, const WAVLTree<int, int> &tree)
+{
+    const WAVLStats &s = tree.getStats();
+    ostringstream note;
+    note << fixed << setprecision(3) << workload << "/" << name
+         << ": rotations per insert " << (double)s.insertRotations / max(s.inserts, 1UL)
+         << ", rank changes per insert " << (double)s.insertRankChanges / max(s.inserts, 1UL)
+         << ", rotations per remove " << (double)s.removeRotations / max(s.removes, 1UL)
+         << ", rank changes per remove " << (double)s.removeRankChanges / max(s.removes, 1UL);
+    benchNotes.push_back(note.str());
+}
+
+/**
+ * Runs one workload against a freshly constructed tree of the given type.
+ */
+template <class Tree>
+static void runWorkload(const Workload &w, const string &treeName, OpStats &stats)
+{
+    Tree tree;
+    if (!w.churn)
+    {
+        for (size_t i = 0; i < w.inserts.size(); ++i)
+        {
+            timedInsert(tree, w.inserts[i], stats);
+        }
+        for (size_t i = 0; i < w.finds.size(); ++i)
+        {
+            timedFind(tree, w.finds[i], stats);
+        }
+        timedIterate(tree, stats);
+        for (size_t i = 0; i < w.removes.size(); ++i)
+        {
+            timedRemove(tree, w.removes[i], stats);
+        }
+    }
+    else
+    {
+        size_t n = w.removes.size();
+        for (size_t i = 0; i < n; ++i)
+        {
+            timedInsert(tree, w.inserts[i], stats);
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            timedRemove(tree, w.removes[i], stats);
+            timedInsert(tree, w.inserts[n + i], stats);
+        }
+        for (size_t i = 0; i < w.finds.size(); ++i)
+        {
+            timedFind(tree, w.finds[i], stats);
+        }
+        timedIterate(tree, stats);
+    }
+    noteTreeStats(w.name, treeName, tree);
+}
+
+/**
+ * Dispatches a tree name to the matching instantiation. Returns false if the
+ * name is unknown.
+ */
+static bool runTree(const string &tree, const Workload &w, OpStats &stats)
+{
+    if (tree == "bst")
+    {
+        runWorkload<BinarySearchTree<int, int> >(w, tree, stats);
+    }
+    else if (tree == "avl")
+    {
+        runWorkload<AVLTree<int, int> >(w, tree, stats);
+    }
+    else if (tree == "rb")
+    {
+        runWorkload<RedBlackTree<int, int> >(w, tree, stats);
+    }
+    else if (tree == "splay")
+    {
+        runWorkload<SplayTree<int, int> >(w, tree, stats);
+    }
+    else if (tree == "wavl")
+    {
+        runWorkload<WAVLTree<int, int> >(w, tree, stats);
+    }
+    else if (tree == "sg")
+    {
+        runWorkload<ScapegoatTree<int, int> >(w, tree, stats);
+    }
+    else if (tree == "idx")
+    {
+        runWorkload<IndexedAVLTree<int, int> >(w, tree, stats);
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+static ResultRow summarize(const string &workload, const string &tree, const string &op,
+                           const LatencyHistogram &h)
+{
+    double scale = LatencyClock::nanosPerTick();
+    ResultRow row;
+    row.workload = workload;
+    row.tree = tree;
+    row.op = op;
+    row.count = h.count();
+    row.mean = h.mean() * scale;
+    row.p50 = (double)h.percentile(50.0) * scale;
+    row.p99 = (double)h.percentile(99.0) * scale;
+    row.p999 = (double)h.percentile(99.9) * scale;
+    row.max = (double)h.max() * scale;
+    return row;
+}
+
+static void printHeader()
+{
+    cout << left << setw(10) << "workload" << setw(10) << "tree" << setw(8) << "op"
+         << right << setw(10) << "count" << setw(10) << "mean" << setw(10) << "p50"
+         << setw(10) << "p99" << setw(10) << "p99.9" << setw(12) << "max" << "   (ns)" << endl;
+}
+
+static void printRow(const ResultRow &r)
+{
+    cout << left << setw(10) << r.workload << setw(10) << r.tree << setw(8) << r.op
+         << right << fixed << setprecision(0) << setw(10) << r.count << setw(10) << r.mean
+         << setw(10) << r.p50 << setw(10) << r.p99 << setw(10) << r.p999 << setw(12) << r.max
+         << endl;
+}
+
+static bool loadRows(const string &path, vector<ResultRow> &rows)
+{
+    ifstream in(path.c_str());
+    if (!in)
+    {
+        cerr << "cannot open " << path << endl;
+        return false;
+    }
+    string line;
+    while (getline(in, line))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        istringstream ss(line);
+        ResultRow r;
+        if (ss >> r.workload >> r.tree >> r.op >> r.count >> r.mean >> r.p50 >> r.p99 >> r.p999 >> r.max)
+        {
+            rows.push_back(r);
+        }
+    }
+    return true;
+}
+
+/**
+ * Prints, for every row present in both runs, the candidate's percentiles as
+ * a ratio of the baseline's (below 1.00 is an improvement).
+ */
+static int compareRuns(const string &basePath, const string &candPath)
+{
+    vector<ResultRow> base, cand;
+    if (!loadRows(basePath, base) || !loadRows(candPath, cand))
+    {
+        return 1;
+    }
+    map<string, ResultRow> byKey;
+    for (size_t i = 0; i < base.size(); ++i)
+    {
+        byKey[base[i].workload + "/" + base[i].tree + "/" + base[i].op] = base[i];
+    }
+    cout << left << setw(10) << "workload" << setw(10) << "tree" << setw(8) << "op" << right
+         << setw(10) << "mean" << setw(10) << "p50" << setw(10) << "p99" << setw(10) << "p99.9"
+         << setw(10) << "max" << "   (candidate / baseline)" << endl;
+    for (size_t i = 0; i < cand.size(); ++i)
+    {
+        const ResultRow &c = cand[i];
+        map<string, ResultRow>::iterator it = byKey.find(c.workload + "/" + c.tree + "/" + c.op);
+        if (it == byKey.end())
+        {
+            continue;
+        }
+        const ResultRow &b = it->second;
+        cout << left << setw(10) << c.workload << setw(10) << c.tree << setw(8) << c.op << right
+             << fixed << setprecision(2)
+             << setw(10) << c.mean / max(b.mean, 1.0) << setw(10) << c.p50 / max(b.p50, 1.0)
+             << setw(10) << c.p99 / max(b.p99, 1.0) << setw(10) << c.p999 / max(b.p999, 1.0)
+             << setw(10) << c.max / max(b.max, 1.0) << endl;
+    }
+    return 0;
+}
+
+/**
+ * Returns the bytes currently allocated from the heap, or 0 where the C
+ * library gives no way to ask.
+ */
+static size_t heapInUse()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+    // large blocks are mmapped and only show up in hblkhd
+    return info.uordblks + info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * Prints the node size and the measured heap cost per entry of a tree filled
+ * with n random keys. The heap figure includes the allocator's per-chunk
+ * header and rounding, which is what a map of small keys actually pays.
+ */
+template <class Tree>
+static void reportMemory(const string &name, size_t nodeBytes, int n)
+{
+    vector<int> keys = sequentialKeys(n);
+    shuffleKeys(keys);
+    size_t before = heapInUse();
+    Tree *tree = new Tree;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        tree->insert(std::make_pair(keys[i], keys[i]));
+    }
+    size_t after = heapInUse();
+    cout << left << setw(10) << name << right << setw(12) << nodeBytes << setw(20) << fixed
+         << setprecision(1) << (double)(after - before) / (double)n << endl;
+    delete tree;
+}
+
+static void printMemory(int n)
+{
+    cout << left << setw(10) << "tree" << right << setw(12) << "node bytes" << setw(20) << "heap bytes/entry"
+         << "   (n=" << n << ", int keys and values)" << endl;
+    reportMemory<BinarySearchTree<int, int> >("bst", sizeof(Node<int, int>), n);
+    reportMemory<AVLTree<int, int> >("avl", sizeof(AVLNode<int, int>), n);
+    reportMemory<RedBlackTree<int, int> >("rb", sizeof(RBNode<int, int>), n);
+    reportMemory<SplayTree<int, int> >("splay", sizeof(Node<int, int>), n);
+    reportMemory<WAVLTree<int, int> >("wavl", sizeof(WAVLNode<int, int>), n);
+    reportMemory<ScapegoatTree<int, int> >("sg", sizeof(Node<int, int>), n);
+    reportMemory<IndexedAVLTree<int, int> >("idx", IndexedAVLTree<int, int>::slotBytes(), n);
+
+    // the same AVL tree with its nodes packed into chunks, which removes the
+    // per-allocation malloc overhead
+    vector<int> keys = sequentialKeys(n);
+    shuffleKeys(keys);
+    size_t before = heapInUse();
+    MonotonicNodeResource *mono = new MonotonicNodeResource(1 << 20);
+    AVLTree<int, int> *tree = new AVLTree<int, int>(mono);
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        tree->insert(std::make_pair(keys[i], keys[i]));
+    }
+    size_t after = heapInUse();
+    MemoryUsage usage = tree->memory_usage();
+    cout << left << setw(10) << "avl-mono" << right << setw(12) << usage.nodeBytes << setw(20) << fixed
+         << setprecision(1) << (double)(after - before) / (double)n << "   (" << usage.allocations
+         << " node allocations, " << mono->bytesReserved() << " bytes reserved)" << endl;
+    delete tree;
+    delete mono;
+}
+
+/**
+ * Compares one find() per key against find_batch() on an AVLTree of n random
+ * keys. Pick n so the tree is well beyond the last-level cache (a 4M-entry
+ * int tree is about 256MB) to see memory-latency overlap.
+ */
+static void printBatch(int n)
+{
+    vector<int> keys = sequentialKeys(n);
+    shuffleKeys(keys);
+    AVLTree<int, int> tree;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        tree.insert(std::make_pair(keys[i], keys[i]));
+    }
+    vector<int> lookups = keys;
+    shuffleKeys(lookups);
+
+    uint64_t start = LatencyClock::now();
+    for (size_t i = 0; i < lookups.size(); ++i)
+    {
+        benchSink += tree.find(lookups[i])->second;
+    }
+    double serial = (double)LatencyClock::toNanos(LatencyClock::now() - start) / (double)lookups.size();
+    cout << left << setw(14) << "batch size" << right << setw(12) << "ns/lookup" << setw(10) << "speedup"
+         << "   (n=" << n << ")" << endl;
+    cout << left << setw(14) << "1 (find)" << right << fixed << setprecision(1) << setw(12) << serial
+         << setw(10) << 1.0 << endl;
+
+    const size_t sizes[] = {16, 64, 256, 512};
+    vector<AVLTree<int, int>::iterator> out;
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+        out.resize(sizes[s]);
+        start = LatencyClock::now();
+        for (size_t i = 0; i + sizes[s] <= lookups.size(); i += sizes[s])
+        {
+            tree.find_batch(&lookups[i], sizes[s], &out[0]);
+            benchSink += out[0]->second;
+        }
+        size_t done = lookups.size() - lookups.size() % sizes[s];
+        double batched = (double)LatencyClock::toNanos(LatencyClock::now() - start) / (double)done;
+        cout << left << setw(14) << sizes[s] << right << setw(12) << batched << setw(10) << serial / batched
+             << endl;
+    }
+}
+
+/**
+ * Average ns per find() over lookups.
+ */
+static double timeFinds(const AVLTree<int, int> &tree, const vector<int> &lookups)
+{
+    uint64_t start = LatencyClock::now();
+    for (size_t i = 0; i < lookups.size(); ++i)
+    {
+        benchSink += tree.find(lookups[i])->second;
+    }
+    return (double)LatencyClock::toNanos(LatencyClock::now() - start) / (double)lookups.size();
+}
+
+/**
+ * Builds an AVLTree of n random keys, churns it so that the nodes end up
+ * scattered across the heap, then times random finds before and after
+ * compact().
+ */
+static void printCompact(int n)
+{
+    vector<int> keys = sequentialKeys(2 * n);
+    shuffleKeys(keys);
+    AVLTree<int, int> tree;
+    for (int i = 0; i < n; ++i)
+    {
+        tree.insert(std::make_pair(keys[i], keys[i]));
+    }
+    // replacing every key with a fresh one interleaves the allocations
+    for (int i = 0; i < n; ++i)
+    {
+        tree.remove(keys[i]);
+        tree.insert(std::make_pair(keys[n + i], keys[n + i]));
+    }
+    vector<int> lookups(keys.begin() + n, keys.end());
+    shuffleKeys(lookups);
+
+    double before = timeFinds(tree, lookups);
+    uint64_t start = LatencyClock::now();
+    tree.compact();
+    double compactMs = (double)LatencyClock::toNanos(LatencyClock::now() - start) / 1e6;
+    double after = timeFinds(tree, lookups);
+
+    cout << fixed << setprecision(1) << "n=" << n << "  find ns: churned " << before << ", compacted " << after
+         << " (" << setprecision(2) << before / after << "x); compact() took " << setprecision(1) << compactMs
+         << " ms" << endl;
+}
+
+/**
+ * Compares root-first find() and insert() against find_from() and
+ * insert_near() seeded with the previous result, for keys visited in sorted
+ * order on an AVLTree of n random keys.
+ */
+static void printFinger(int n)
+{
+    vector<int> keys = sequentialKeys(n);
+    shuffleKeys(keys);
+    AVLTree<int, int> tree;
+    AVLTree<int, int> rootTree;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        tree.insert(std::make_pair(2 * keys[i], keys[i]));
+        rootTree.insert(std::make_pair(2 * keys[i], keys[i]));
+    }
+
+    uint64_t start = LatencyClock::now();
+    for (int i = 0; i < n; ++i)
+    {
+        benchSink += tree.find(2 * i)->second;
+    }
+    double rootFind = (double)LatencyClock::toNanos(LatencyClock::now() - start) / (double)n;
+
+    AVLTree<int, int>::iterator hint = tree.end();
+    start = LatencyClock::now();
+    for (int i = 0; i < n; ++i)
+    {
+        hint = tree.find_from(hint, 2 * i);
+        benchSink += hint->second;
+    }
+    double fingerFind = (double)LatencyClock::toNanos(LatencyClock::now() - start) / (double)n;
+
+    // odd keys fill the gaps, so every insert lands next to the previous one
+    start = LatencyClock::now();
+    for (int i = 0; i < n; ++i)
+    {
+        rootTree.insert(std::make_pair(2 * i + 1, i));
+    }
+    double rootInsert = (double)LatencyClock::toNanos(LatencyClock::now() - start) / (double)n;
+
+    hint = tree.end();
+    start = LatencyClock::now();
+    for (int i = 0; i < n; ++i)
+    {
+        hint = tree.insert_near(hint, std::make_pair(2 * i + 1, i));
+    }
+    double fingerInsert = (double)LatencyClock::toNanos(LatencyClock::now() - start) / (double)n;
+
+    cout << fixed << setprecision(1) << "n=" << n << " sorted access, ns/op\n"
+         << "  find " << rootFind << "  find_from " << fingerFind << "\n"
+         << "  insert " << rootInsert << "  insert_near " << fingerInsert << endl;
+}
+
+/**
+ * Times range sums over random ranges of about n/10 keys, scanning an
+ * AVLTree with iterators against AugmentedAVLTree::aggregate().
+ */
+static void printAggregate(int n)
+{
+    vector<int> keys = sequentialKeys(n);
+    shuffleKeys(keys);
+    AVLTree<int, int> plain;
+    AugmentedAVLTree<int, long> augmented;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        plain.insert(std::make_pair(keys[i], keys[i]));
+        augmented.insert(std::make_pair(keys[i], (long)keys[i]));
+    }
+
+    const int queries = 1000;
+    int width = std::max(1, n / 10);
+    vector<int> starts(queries);
+    for (int i = 0; i < queries; ++i)
+    {
+        starts[i] = (int)(nextRandom() % (uint64_t)std::max(1, n - width));
+    }
+
+    uint64_t start = LatencyClock::now();
+    for (int i = 0; i < queries; ++i)
+    {
+        long sum = 0;
+        AVLTree<int, int>::iterator it = plain.find(starts[i]);
+        for (; it != plain.end() && it->first <= starts[i] + width; ++it)
+        {
+            sum += it->second;
+        }
+        benchSink += sum;
+    }
+    double scan = (double)LatencyClock::toNanos(LatencyClock::now() - start) / queries;
+
+    start = LatencyClock::now();
+    for (int i = 0; i < queries; ++i)
+    {
+        benchSink += augmented.aggregate(starts[i], starts[i] + width);
+    }
+    double agg = (double)LatencyClock::toNanos(LatencyClock::now() - start) / queries;
+
+    cout << fixed << setprecision(1) << "n=" << n << " range width " << width << ", ns/query: scan " << scan
+         << ", aggregate " << agg << endl;
+}
+
+/**
+ * Times adding a delta to every value in random ranges of about n/10 keys,
+ * through iterators on an AVLTree against LazyAVLTree::rangeAdd().
+ */
+static void printLazy(int n)
+{
+    vector<int> keys = sequentialKeys(n);
+    shuffleKeys(keys);
+    AVLTree<int, long> plain;
+    LazyAVLTree<int, long> lazy;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        plain.insert(std::make_pair(keys[i], (long)keys[i]));
+        lazy.insert(std::make_pair(keys[i], (long)keys[i]));
+    }
+
+    const int updates = 100;
+    int width = std::max(1, n / 10);
+    vector<int> starts(updates);
+    for (int i = 0; i < updates; ++i)
+    {
+        starts[i] = (int)(nextRandom() % (uint64_t)std::max(1, n - width));
+    }
+
+    uint64_t start = LatencyClock::now();
+    for (int i = 0; i < updates; ++i)
+    {
+        AVLTree<int, long>::iterator it = plain.find(starts[i]);
+        for (; it != plain.end() && it->first <= starts[i] + width; ++it)
+        {
+            it->second += 1;
+        }
+    }
+    double scan = (double)LatencyClock::toNanos(LatencyClock::now() - start) / updates;
+
+    start = LatencyClock::now();
+    for (int i = 0; i < updates; ++i)
+    {
+        lazy.rangeAdd(starts[i], starts[i] + width, 1);
+    }
+    double tagged = (double)LatencyClock::toNanos(LatencyClock::now() - start) / updates;
+    benchSink += lazy.aggregateAll();
+
+    cout << fixed << setprecision(1) << "n=" << n << " range width " << width << ", ns/update: iterate " << scan
+         << ", rangeAdd " << tagged << endl;
+}
+
+/**
+ * Times stabbing queries over n random intervals of length up to 1000 in a
+ * key space of 100n, scanning an AVLTree keyed by start time against
+ * IntervalTree::stab().
+ */
+static void printInterval(int n)
+{
+    AVLTree<int, int> byStart;
+    IntervalTree<int, int> intervals;
+    int span = 100 * n;
+    for (int i = 0; i < n; ++i)
+    {
+        int start = (int)(nextRandom() % (uint64_t)span);
+        int end = start + (int)(nextRandom() % 1000);
+        byStart.insert(std::make_pair(start, end));
+        intervals.insert(start, end, i);
+    }
+
+    const int queries = 200;
+    vector<int> points(queries);
+    for (int i = 0; i < queries; ++i)
+    {
+        points[i] = (int)(nextRandom() % (uint64_t)span);
+    }
+
+    // without the max end point, every interval starting before the point
+    // has to be checked
+    uint64_t start = LatencyClock::now();
+    for (int i = 0; i < queries; ++i)
+    {
+        long hits = 0;
+        for (AVLTree<int, int>::iterator it = byStart.begin(); it != byStart.end() && it->first <= points[i]; ++it)
+        {
+            hits += (it->second >= points[i]);
+        }
+        benchSink += hits;
+    }
+    double scan = (double)LatencyClock::toNanos(LatencyClock::now() - start) / queries;
+
+    vector<IntervalTree<int, int>::iterator> out;
+    start = LatencyClock::now();
+    for (int i = 0; i < queries; ++i)
+    {
+        out.clear();
+        intervals.stab(points[i], out);
+        benchSink += out.size();
+    }
+    double tree = (double)LatencyClock::toNanos(LatencyClock::now() - start) / queries;
+
+    cout << fixed << setprecision(1) << "n=" << n << " intervals, ns/stab: scan " << scan << ", interval tree "
+         << tree << endl;
+}
+
+/**
+ * Times the recursive isBalanced() against AVLTree::validate(), which checks
+ * every invariant, on one thread and on `threads` threads.
+ */
+static void printValidate(int n, unsigned threads)
+{
+    AVLTree<int, int> tree;
+    vector<int> keys(n);
+    for (int i = 0; i < n; ++i)
+    {
+        keys[i] = i;
+    }
+    shuffleKeys(keys);
+    for (int i = 0; i < n; ++i)
+    {
+        tree.insert(std::make_pair(keys[i], i));
+    }
+
+    uint64_t start = LatencyClock::now();
+    bool balanced = tree.isBalanced();
+    double recursive = (double)LatencyClock::toNanos(LatencyClock::now() - start) / 1e6;
+    start = LatencyClock::now();
+    bool valid = tree.validate(1);
+    double single = (double)LatencyClock::toNanos(LatencyClock::now() - start) / 1e6;
+    start = LatencyClock::now();
+    bool validParallel = tree.validate(threads);
+    double parallel = (double)LatencyClock::toNanos(LatencyClock::now() - start) / 1e6;
+
+    cout << fixed << setprecision(2) << "n=" << n << " ms: isBalanced " << recursive << " (" << balanced
+         << "), validate " << single << " (" << valid << "), validate on " << threads << " threads " << parallel
+         << " (" << validParallel << ")" << endl;
+}
+
+template <class Tree>
+static TreeProfile profileTree(const vector<int> &keys)
+{
+    Tree tree;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        tree.insert(std::make_pair(keys[i], keys[i]));
+    }
+    return tree.profile();
+}
+
+/**
+ * Builds each tree from the same n keys (random or sorted) and prints the
+ * shape of the result, comparing its mean search path with the optimum.
+ * With a save path, also writes every profile as JSON, one tree per line.
+ */
+static int printProfile(int n, const string &workload, vector<string> trees, const string &savePath)
+{
+    vector<int> keys = sequentialKeys(n);
+    if (workload != "sorted")
+    {
+        shuffleKeys(keys);
+    }
+    if (trees.empty())
+    {
+        const char *all[] = {"bst", "avl", "rb", "splay", "wavl", "sg"};
+        trees.assign(all, all + 6);
+    }
+    ofstream json;
+    if (!savePath.empty())
+    {
+        json.open(savePath.c_str());
+    }
+    cout << left << setw(8) << "tree" << right << setw(10) << "nodes" << setw(10) << "leaves" << setw(10)
+         << "max path" << setw(10) << "avg path" << setw(10) << "optimal" << "   (" << workload << " inserts)"
+         << endl;
+    for (size_t i = 0; i < trees.size(); ++i)
+    {
+        TreeProfile p;
+        if (trees[i] == "bst" && workload == "sorted" && n > 20000)
+        {
+            cout << left << setw(8) << "bst" << "   skipped (O(n^2) on sorted input)" << endl;
+            continue;
+        }
+        else if (trees[i] == "bst")
+        {
+            p = profileTree<BinarySearchTree<int, int> >(keys);
+        }
+        else if (trees[i] == "avl")
+        {
+            p = profileTree<AVLTree<int, int> >(keys);
+        }
+        else if (trees[i] == "rb")
+        {
+            p = profileTree<RedBlackTree<int, int> >(keys);
+        }
+        else if (trees[i] == "splay")
+        {
+            p = profileTree<SplayTree<int, int> >(keys);
+        }
+        else if (trees[i] == "wavl")
+        {
+            p = profileTree<WAVLTree<int, int> >(keys);
+        }
+        else if (trees[i] == "sg")
+        {
+            p = profileTree<ScapegoatTree<int, int> >(keys);
+        }
+        else
+        {
+            cerr << "unknown tree for -profile: " << trees[i] << endl;
+            return 1;
+        }
+        cout << left << setw(8) << trees[i] << right << setw(10) << p.nodes << setw(10) << p.leaves << setw(10)
+             << p.maxPathLength << fixed << setprecision(2) << setw(10) << p.averagePathLength << setw(10)
+             << p.optimalPathLength << endl;
+        if (json.is_open())
+        {
+            json << "{\"tree\":\"" << trees[i] << "\",\"workload\":\"" << workload << "\",\"profile\":";
+            p.writeJson(json);
+            json << "}\n";
+        }
+    }
+    return 0;
+}
+
+/**
+ * Writes an AVLTree of n random keys as DOT or NDJSON to savePath (or
+ * /dev/null) and reports the throughput.
+ */
+static int printExport(int n, const string &format, const string &savePath)
+{
+    vector<int> keys = sequentialKeys(n);
+    shuffleKeys(keys);
+    AVLTree<int, int> tree;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        tree.insert(std::make_pair(keys[i], keys[i]));
+    }
+    string path = savePath.empty() ? "/dev/null" : savePath;
+    ofstream out(path.c_str(), ios::binary);
+    if (!out)
+    {
+        cerr << "cannot write " << path << endl;
+        return 1;
+    }
+    uint64_t start = LatencyClock::now();
+    if (format == "dot")
+    {
+        tree.writeDot(out);
+    }
+    else
+    {
+        tree.writeJsonLines(out);
+    }
+    out.flush();
+    double seconds = (double)LatencyClock::toNanos(LatencyClock::now() - start) / 1e9;
+    double bytes = (double)out.tellp();
+    cout << fixed << setprecision(1) << "n=" << n << " " << format << " to " << path << ": " << seconds * 1e3
+         << " ms, " << (double)n / seconds / 1e6 << " M nodes/s";
+    if (bytes > 0)
+    {
+        cout << ", " << bytes / seconds / 1e6 << " MB/s";
+    }
+    cout << endl;
+    return 0;
+}
+
+/**
+ * Finds each of `queries` random keys among 0..n-1 and returns the average
+ * nanoseconds per find.
+ */
+template <class Tree>
+static double timeFinds(const Tree &tree, int n, int queries)
+{
+    vector<int> keys(queries);
+    for (int i = 0; i < queries; ++i)
+    {
+        keys[i] = (int)(nextRandom() % (uint64_t)n);
+    }
+    uint64_t start = LatencyClock::now();
+    for (int i = 0; i < queries; ++i)
+    {
+        benchSink += (tree.find(keys[i]) != tree.end());
+    }
+    return (double)LatencyClock::toNanos(LatencyClock::now() - start) / queries;
+}
+
+/**
+ * Shows what rebalance() does to a BinarySearchTree that sorted inserts
+ * turned into a chain, and what auto-rebalancing costs for sorted inserts
+ * next to an AVLTree. Building the chain takes O(n^2), so it is capped at
+ * 30000 nodes.
+ */
+static void printRebalance(int n)
+{
+    int chainSize = std::min(n, 30000);
+    BinarySearchTree<int, int> chain;
+    for (int i = 0; i < chainSize; ++i)
+    {
+        chain.insert(std::make_pair(i, i));
+    }
+    double before = timeFinds(chain, chainSize, 200);
+    size_t heightBefore = chain.profile().maxPathLength;
+    uint64_t start = LatencyClock::now();
+    chain.rebalance();
+    double dsw = (double)LatencyClock::toNanos(LatencyClock::now() - start) / 1e6;
+    double after = timeFinds(chain, chainSize, 100000);
+    cout << fixed << setprecision(1) << "n=" << chainSize << " chain of height " << heightBefore << ": rebalance() "
+         << dsw << " ms to height " << chain.profile().maxPathLength << ", ns/find " << before << " -> " << after
+         << endl;
+
+    BinarySearchTree<int, int> autoTree;
+    autoTree.setAutoRebalance(2.0);
+    start = LatencyClock::now();
+    for (int i = 0; i < n; ++i)
+    {
+        autoTree.insert(std::make_pair(i, i));
+    }
+    double autoInsert = (double)LatencyClock::toNanos(LatencyClock::now() - start) / n;
+    AVLTree<int, int> avl;
+    start = LatencyClock::now();
+    for (int i = 0; i < n; ++i)
+    {
+        avl.insert(std::make_pair(i, i));
+    }
+    double avlInsert = (double)LatencyClock::toNanos(LatencyClock::now() - start) / n;
+    cout << "n=" << n << " sorted inserts, ns/insert: bst with auto-rebalance (c=2) " << autoInsert << " (height "
+         << autoTree.profile().maxPathLength << "), avl " << avlInsert << " (height " << avl.profile().maxPathLength
+         << ")" << endl;
+}
+
+/**
+ * Runs the hold model of a timer queue on AVLTrees of n random deadlines:
+ * each step takes the earliest deadline out and schedules a later one.
+ * Compares removing begin() by key against pop_min(), which unlinks the
+ * cached minimum without a search.
+ */
+static void printPopMin(int n)
+{
+    // a key is a deadline in the high half and a unique timer id in the low
+    // half, as a timer wheel would break ties
+    vector<long long> delays(n);
+    for (int i = 0; i < n; ++i)
+    {
+        delays[i] = 1 + (long long)(nextRandom() % (uint64_t)n);
+    }
+    AVLTree<long long, int> byKey;
+    AVLTree<long long, int> popped;
+    for (int i = 0; i < n; ++i)
+    {
+        long long key = ((long long)(nextRandom() % (uint64_t)n) << 32) | i;
+        byKey.insert(std::make_pair(key, i));
+        popped.insert(std::make_pair(key, i));
+    }
+
+    uint64_t start = LatencyClock::now();
+    for (int i = 0; i < n; ++i)
+    {
+        long long first = byKey.begin()->first;
+        byKey.remove(first);
+        byKey.insert(std::make_pair((((first >> 32) + delays[i]) << 32) | (n + i), i));
+    }
+    double removeKey = (double)LatencyClock::toNanos(LatencyClock::now() - start) / (double)n;
+
+    start = LatencyClock::now();
+    for (int i = 0; i < n; ++i)
+    {
+        long long first = popped.begin()->first;
+        popped.pop_min();
+        popped.insert(std::make_pair((((first >> 32) + delays[i]) << 32) | (n + i), i));
+    }
+    double popMin = (double)LatencyClock::toNanos(LatencyClock::now() - start) / (double)n;
+
+    cout << fixed << setprecision(1) << "n=" << n << " hold steps (take the minimum, insert a later key), ns/step\n"
+         << "  remove(begin()->first) " << removeKey << "  pop_min() " << popMin << endl;
+}
+
+/**
+ * Returns the best of three full traversals from first to last, in ns per
+ * item, after summing the keys into benchSink.
+ */
+template <class Step>
+static double timeTraversal(Step step, int n)
+{
+    double best = 0;
+    for (int run = 0; run < 3; ++run)
+    {
+        uint64_t start = LatencyClock::now();
+        benchSink += step();
+        double ns = (double)LatencyClock::toNanos(LatencyClock::now() - start) / (double)n;
+        if (run == 0 || ns < best)
+        {
+            best = ns;
+        }
+    }
+    return best;
+}
+
+/**
+ * Times full in-order traversals of an AVLTree of n random keys forwards
+ * and backwards with iterator, reverse_iterator and stack_cursor, which
+ * follows child links only.
+ */
+static void printIterate(int n)
+{
+    vector<int> keys = sequentialKeys(n);
+    shuffleKeys(keys);
+    AVLTree<int, int> tree;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        tree.insert(std::make_pair(keys[i], keys[i]));
+    }
+
+    double forward = timeTraversal([&tree]() {
+        long sum = 0;
+        for (AVLTree<int, int>::iterator it = tree.begin(); it != tree.end(); ++it)
+        {
+            sum += it->first;
+        }
+        return sum;
+    }, n);
+    double backward = timeTraversal([&tree]() {
+        long sum = 0;
+        AVLTree<int, int>::iterator it = tree.end();
+        while (it != tree.begin())
+        {
+            --it;
+            sum += it->first;
+        }
+        return sum;
+    }, n);
+    double reverse = timeTraversal([&tree]() {
+        long sum = 0;
+        for (AVLTree<int, int>::reverse_iterator it = tree.rbegin(); it != tree.rend(); ++it)
+        {
+            sum += it->first;
+        }
+        return sum;
+    }, n);
+    double cursor = timeTraversal([&tree]() {
+        long sum = 0;
+        AVLTree<int, int>::stack_cursor end = tree.end_cursor();
+        for (AVLTree<int, int>::stack_cursor c = tree.begin_cursor(); c != end; ++c)
+        {
+            sum += c->first;
+        }
+        return sum;
+    }, n);
+    double cursorBack = timeTraversal([&tree]() {
+        long sum = 0;
+        AVLTree<int, int>::stack_cursor c = tree.end_cursor();
+        AVLTree<int, int>::stack_cursor first = tree.begin_cursor();
+        while (c != first)
+        {
+            --c;
+            sum += c->first;
+        }
+        return sum;
+    }, n);
+
+    cout << fixed << setprecision(2) << "n=" << n << " full traversal, ns/item, best of 3\n"
+         << "  iterator ++ " << forward << "  -- " << backward << "  reverse_iterator " << reverse << "\n"
+         << "  stack_cursor ++ " << cursor << "  -- " << cursorBack << endl;
+}
+
+// Items per map in the -static comparison, the size StaticAVLTree is made for
+static const int SMALL_MAP_SIZE = 4096;
+
+// Items per map in the -small comparison: within, at and past the inline
+// slots of a default SmallAVLTree, and past SmallAVLTree<16> as well
+static const int TINY_MAP_SIZES[] = {2, 4, 12, 32};
+
+// Maps filled side by side to measure the heap bytes of one
+static const int MEASURED_MAPS = 64;
+
+/**
+ * Returns the heap bytes a map of the given keys holds beyond the tree
+ * object, averaged over MEASURED_MAPS maps filled together so that chunks
+ * the allocator keeps cached from earlier runs barely show in the average.
+ */
+template <class Tree>
+static size_t smallMapHeapBytes(const vector<int> &keys)
+{
+    vector<Tree *> trees;
+    for (int m = 0; m < MEASURED_MAPS; ++m)
+    {
+        trees.push_back(new Tree);
+    }
+    size_t before = heapInUse();
+    for (int m = 0; m < MEASURED_MAPS; ++m)
+    {
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            trees[m]->insert(std::make_pair(keys[i], (int)i));
+        }
+    }
+    size_t after = heapInUse();
+    for (int m = 0; m < MEASURED_MAPS; ++m)
+    {
+        delete trees[m];
+    }
+    return after > before ? (after - before) / MEASURED_MAPS : 0;
+}
+
+/**
+ * Fills, searches and empties a map of size keys over and over until n keys
+ * have gone through it, and prints ns per insert, find and remove with the
+ * heap bytes the full map holds and its total bytes: the tree object itself
+ * plus those heap bytes.
+ */
+template <class Tree>
+static void reportSmallMap(const string &name, int n, int size)
+{
+    vector<int> keys = sequentialKeys(size);
+    shuffleKeys(keys);
+    int rounds = max(1, n / size);
+    uint64_t insertNs = 0, findNs = 0, removeNs = 0;
+    for (int round = 0; round < rounds; ++round)
+    {
+        Tree tree;
+        uint64_t start = LatencyClock::now();
+        for (int i = 0; i < size; ++i)
+        {
+            tree.insert(std::make_pair(keys[i], i));
+        }
+        insertNs += LatencyClock::toNanos(LatencyClock::now() - start);
+        start = LatencyClock::now();
+        for (int i = size - 1; i >= 0; --i)
+        {
+            benchSink += tree.find(keys[i])->second;
+        }
+        findNs += LatencyClock::toNanos(LatencyClock::now() - start);
+        start = LatencyClock::now();
+        for (int i = 0; i < size; ++i)
+        {
+            tree.remove(keys[i]);
+        }
+        removeNs += LatencyClock::toNanos(LatencyClock::now() - start);
+    }
+    double ops = (double)rounds * size;
+    size_t heapBytes = smallMapHeapBytes<Tree>(keys);
+    cout << left << setw(10) << name << right << fixed << setprecision(1) << setw(10) << insertNs / ops << setw(10)
+         << findNs / ops << setw(10) << removeNs / ops << setw(14) << heapBytes << setw(14)
+         << sizeof(Tree) + heapBytes << endl;
+}
+
+/**
+ * Compares StaticAVLTree with the heap-backed AVL trees on maps of
+ * SMALL_MAP_SIZE int keys.
+ */
+static void printStatic(int n)
+{
+    cout << left << setw(10) << "tree" << right << setw(10) << "insert" << setw(10) << "find" << setw(10)
+         << "remove" << setw(14) << "heap bytes" << setw(14) << "map bytes" << "   (ns/op, maps of " << SMALL_MAP_SIZE
+         << " keys)" << endl;
+    reportSmallMap<AVLTree<int, int> >("avl", n, SMALL_MAP_SIZE);
+    reportSmallMap<IndexedAVLTree<int, int> >("idx", n, SMALL_MAP_SIZE);
+    reportSmallMap<StaticAVLTree<int, int, SMALL_MAP_SIZE> >("static", n, SMALL_MAP_SIZE);
+}
+
+/**
+ * Compares SmallAVLTree, with the default and with 16 inline slots, with
+ * AVLTree on maps of each of TINY_MAP_SIZES int keys. Map bytes is what a
+ * map of that size really costs, empty slots included.
+ */
+static void printSmall(int n)
+{
+    cout << left << setw(10) << "tree" << right << setw(10) << "insert" << setw(10) << "find" << setw(10)
+         << "remove" << setw(14) << "heap bytes" << setw(14) << "map bytes" << "   (ns/op)" << endl;
+    for (size_t i = 0; i < sizeof(TINY_MAP_SIZES) / sizeof(TINY_MAP_SIZES[0]); ++i)
+    {
+        int size = TINY_MAP_SIZES[i];
+        cout << "maps of " << size << " keys" << endl;
+        reportSmallMap<AVLTree<int, int> >("avl", n, size);
+        reportSmallMap<SmallAVLTree<int, int> >("small", n, size);
+        reportSmallMap<SmallAVLTree<int, int, 16> >("small16", n, size);
+    }
+    cout << "sizeof AVLTree " << sizeof(AVLTree<int, int>) << ", SmallAVLTree<" << SmallAVLTree<int, int>::inlineCapacity()
+         << "> " << sizeof(SmallAVLTree<int, int>) << ", SmallAVLTree<16> " << sizeof(SmallAVLTree<int, int, 16>)
+         << " bytes" << endl;
+}
+
+/**
+ * Runs workload w, untimed, on an AVLTree that writes every call to a trace
+ * at path, for bst-replay.
+ */
+static int recordWorkload(const Workload &w, const string &path)
+{
+    ofstream out(path.c_str(), ios::binary);
+    if (!out)
+    {
+        cerr << "cannot open " << path << endl;
+        return 1;
+    }
+    TraceWriter<int, int> writer(out);
+    TracedTree<int, int> tree;
+    tree.startTrace(&writer);
+    size_t fill = w.churn ? w.removes.size() : w.inserts.size();
+    for (size_t i = 0; i < fill; ++i)
+    {
+        tree.insert(std::make_pair(w.inserts[i], w.inserts[i]));
+    }
+    for (size_t i = 0; w.churn && i < w.removes.size(); ++i)
+    {
+        tree.remove(w.removes[i]);
+        tree.insert(std::make_pair(w.inserts[fill + i], w.inserts[fill + i]));
+    }
+    for (size_t i = 0; i < w.finds.size(); ++i)
+    {
+        TracedTree<int, int>::iterator it = tree.find(w.finds[i]);
+        if (it != tree.end())
+        {
+            benchSink += it->second;
+        }
+    }
+    for (TracedTree<int, int>::iterator it = tree.begin(); it != tree.end(); ++it)
+    {
+        benchSink += it->first;
+    }
+    for (size_t i = 0; !w.churn && i < w.removes.size(); ++i)
+    {
+        tree.remove(w.removes[i]);
+    }
+    tree.stopTrace();
+    cout << "wrote " << writer.records() << " records of workload " << w.name << " to " << path << endl;
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    int n = 100000;
+    vector<string> workloads;
+    vector<string> trees;
+    string savePath;
+    bool memory = false;
+    bool batch = false;
+    bool compact = false;
+    bool finger = false;
+    bool aggregate = false;
+    bool lazy = false;
+    bool interval = false;
+    bool validate = false;
+    bool profile = false;
+    string exportFormat;
+    bool rebalance = false;
+    bool popMin = false;
+    bool iterate = false;
+    bool staticTree = false;
+    bool smallTree = false;
+    string recordPath;
+    unsigned threads = std::thread::hardware_concurrency();
+
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        if (arg == "-compare" && i + 2 < argc)
+        {
+            return compareRuns(argv[i + 1], argv[i + 2]);
+        }
+        else if (arg == "-n" && i + 1 < argc)
+        {
+            n = atoi(argv[++i]);
+        }
+        else if (arg == "-seed" && i + 1 < argc)
+        {
+            rngState = strtoull(argv[++i], NULL, 10) | 1;
+        }
+        else if (arg == "-workload" && i + 1 < argc)
+        {
+            workloads.push_back(argv[++i]);
+        }
+        else if (arg == "-tree" && i + 1 < argc)
+        {
+            trees.push_back(argv[++i]);
+        }
+        else if (arg == "-memory")
+        {
+            memory = true;
+        }
+        else if (arg == "-batch")
+        {
+            batch = true;
+        }
+        else if (arg == "-compact")
+        {
+            compact = true;
+        }
+        else if (arg == "-finger")
+        {
+            finger = true;
+        }
+        else if (arg == "-aggregate")
+        {
+            aggregate = true;
+        }
+        else if (arg == "-lazy")
+        {
+            lazy = true;
+        }
+        else if (arg == "-interval")
+        {
+            interval = true;
+        }
+        else if (arg == "-validate")
+        {
+            validate = true;
+        }
+        else if (arg == "-profile")
+        {
+            profile = true;
+        }
+        else if (arg == "-rebalance")
+        {
+            rebalance = true;
+        }
+        else if (arg == "-popmin")
+        {
+            popMin = true;
+        }
+        else if (arg == "-iterate")
+        {
+            iterate = true;
+        }
+        else if (arg == "-static")
+        {
+            staticTree = true;
+        }
+        else if (arg == "-small")
+        {
+            smallTree = true;
+        }
+        else if (arg == "-record" && i + 1 < argc)
+        {
+            recordPath = argv[++i];
+        }
+        else if (arg == "-export" && i + 1 < argc && (string(argv[i + 1]) == "dot" || string(argv[i + 1]) == "ndjson"))
+        {
+            exportFormat = argv[++i];
+        }
+        else if (arg == "-threads" && i + 1 < argc)
+        {
+            threads = (unsigned)atoi(argv[++i]);
+        }
+        else if (arg == "-save" && i + 1 < argc)
+        {
+            savePath = argv[++i];
+        }
+        else
+        {
+            cerr << "usage: " << argv[0]
+                 << " [-n N] [-seed S] [-workload sorted|random|churn|zipf] [-tree bst|avl|rb|splay|wavl|sg|idx] [-save FILE]\n"
+                 << "       " << argv[0] << " -compare BASELINE CANDIDATE\n"
+                 << "       " << argv[0] << " -memory [-n N]\n"
+                 << "       " << argv[0] << " -batch [-n N]\n"
+                 << "       " << argv[0] << " -compact [-n N]\n"
+                 << "       " << argv[0] << " -finger [-n N]\n"
+                 << "       " << argv[0] << " -aggregate [-n N]\n"
+                 << "       " << argv[0] << " -lazy [-n N]\n"
+                 << "       " << argv[0] << " -interval [-n N]\n"
+                 << "       " << argv[0] << " -validate [-n N] [-threads T]\n"
+                 << "       " << argv[0] << " -profile [-n N] [-workload sorted|random] [-tree T] [-save FILE]\n"
+                 << "       " << argv[0] << " -export dot|ndjson [-n N] [-save FILE]\n"
+                 << "       " << argv[0] << " -rebalance [-n N]\n"
+                 << "       " << argv[0] << " -popmin [-n N]\n"
+                 << "       " << argv[0] << " -iterate [-n N]\n"
+                 << "       " << argv[0] << " -static [-n N]\n"
+                 << "       " << argv[0] << " -small [-n N]\n"
+                 << "       " << argv[0] << " -record FILE [-n N] [-workload sorted|random|churn|zipf]" << endl;
+            return 1;
+        }
+    }
+    if (memory)
+    {
+        printMemory(n);
+        return 0;
+    }
+    if (batch)
+    {
+        printBatch(n);
+        return 0;
+    }
+    if (compact)
+    {
+        printCompact(n);
+        return 0;
+    }
+    if (finger)
+    {
+        printFinger(n);
+        return 0;
+    }
+    if (aggregate)
+    {
+        printAggregate(n);
+        return 0;
+    }
+    if (lazy)
+    {
+        printLazy(n);
+        return 0;
+    }
+    if (interval)
+    {
+        printInterval(n);
+        return 0;
+    }
+    if (validate)
+    {
+        printValidate(n, threads);
+        return 0;
+    }
+    if (rebalance)
+    {
+        printRebalance(n);
+        return 0;
+    }
+    if (popMin)
+    {
+        printPopMin(n);
+        return 0;
+    }
+    if (iterate)
+    {
+        printIterate(n);
+        return 0;
+    }
+    if (staticTree)
+    {
+        printStatic(n);
+        return 0;
+    }
+    if (smallTree)
+    {
+        printSmall(n);
+        return 0;
+    }
+    if (!recordPath.empty())
+    {
+        Workload w = makeWorkload(workloads.empty() ? "random" : workloads[0], n);
+        if (w.inserts.empty())
+        {
+            cerr << "unknown workload " << w.name << endl;
+            return 1;
+        }
+        return recordWorkload(w, recordPath);
+    }
+    if (!exportFormat.empty())
+    {
+        return printExport(n, exportFormat, savePath);
+    }
+    if (profile)
+    {
+        return printProfile(n, workloads.empty() ? "random" : workloads[0], trees, savePath);
+    }
+    if (workloads.empty())
+    {
+        workloads.push_back("random");
+        workloads.push_back("sorted");
+        workloads.push_back("churn");
+        workloads.push_back("zipf");
+    }
+    if (trees.empty())
+    {
+        trees.push_back("bst");
+        trees.push_back("avl");
+        trees.push_back("rb");
+        trees.push_back("splay");
+        trees.push_back("wavl");
+        trees.push_back("sg");
+        trees.push_back("idx");
+    }
+
+    vector<ResultRow> rows;
+    printHeader();
+    for (size_t wi = 0; wi < workloads.size(); ++wi)
+    {
+        Workload w = makeWorkload(workloads[wi], n);
+        if (w.inserts.empty())
+        {
+            cerr << "unknown workload " << workloads[wi] << endl;
+            return 1;
+        }
+        for (size_t ti = 0; ti < trees.size(); ++ti)
+        {
+            // the unbalanced tree is quadratic on sorted input; keep it usable
+            if (trees[ti] == "bst" && w.name == "sorted" && n > 20000)
+            {
+                cout << left << setw(10) << w.name << setw(10) << trees[ti]
+                     << "skipped (degenerates to a list above n=20000)" << endl;
+                continue;
+            }
+            OpStats stats;
+            if (!runTree(trees[ti], w, stats))
+            {
+                cerr << "unknown tree " << trees[ti] << endl;
+                return 1;
+            }
+            const char *ops[] = {"insert", "remove", "find", "next"};
+            const LatencyHistogram *hists[] = {&stats.insert, &stats.remove, &stats.find, &stats.next};
+            for (int k = 0; k < 4; ++k)
+            {
+                rows.push_back(summarize(w.name, trees[ti], ops[k], *hists[k]));
+                printRow(rows.back());
+            }
+        }
+    }
+
+    for (size_t i = 0; i < benchNotes.size(); ++i)
+    {
+        cout << benchNotes[i] << endl;
+    }
+
+    if (!savePath.empty())
+    {
+        ofstream out(savePath.c_str());
+        out << "# workload tree op count mean p50 p99 p99.9 max (ns), n=" << n << "\n";
+        for (size_t i = 0; i < rows.size(); ++i)
+        {
+            const ResultRow &r = rows[i];
+            out << r.workload << ' ' << r.tree << ' ' << r.op << ' ' << r.count << ' ' << r.mean << ' '
+                << r.p50 << ' ' << r.p99 << ' ' << r.p999 << ' ' << r.max << "\n";
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,295 @@
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "bst.h"
+#include "avlbst.h"
+#include "rbbst.h"
+#include "splaybst.h"
+#include "wavlbst.h"
+#include "scapegoatbst.h"
+#include "smallavlbst.h"
+#include "trace_bst.h"
+#include "latency_histogram.h"
+
+using namespace std;
+
+/**
+ * Replays a trace recorded with TracedTree (e.g. by bst-bench -record)
+ * against each tree variant. Every tree first replays the whole trace at
+ * full speed for the throughput, then a fresh tree replays it again with
+ * every call timed individually into a LatencyHistogram per kind of call.
+ * Traces with 4- or 8-byte keys and values replay as int32_t or int64_t.
+ *
+ * Usage:
+ *   bst-replay TRACE [-tree bst|avl|rb|splay|wavl|sg|small]...
+ */
+
+// Volatile sink so the optimizer cannot drop lookups whose result is unused.
+static volatile long replaySink = 0;
+
+/**
+ * Per-call latency histograms (recorded in clock ticks).
+ */
+struct ReplayStats
+{
+    LatencyHistogram insert;
+    LatencyHistogram remove;
+    LatencyHistogram find;
+    LatencyHistogram begin;
+    LatencyHistogram next;
+    LatencyHistogram copy;
+};
+
+static void printRow(const string &tree, const string &op, const LatencyHistogram &h)
+{
+    if (h.count() == 0)
+    {
+        return;
+    }
+    double scale = LatencyClock::nanosPerTick();
+    cout << left << setw(10) << tree << setw(8) << op << right << fixed << setprecision(0) << setw(12) << h.count()
+         << setw(10) << h.mean() * scale << setw(10) << (double)h.percentile(50.0) * scale << setw(10)
+         << (double)h.percentile(99.0) * scale << setw(10) << (double)h.percentile(99.9) * scale << setw(12)
+         << (double)h.max() * scale << endl;
+}
+
+// Each iterator of the recorded program is replayed under its id in the
+// trace, so one that stays on an item while others find, begin or remove
+// elsewhere keeps its own position. A valid program never advances an
+// iterator whose item it removed, and neither does its replay.
+
+/**
+ * Replays records once without timing the calls and returns the ticks taken.
+ */
+template <class Tree, class Key, class Value>
+static uint64_t replayUntimed(const vector<TraceRecord<Key, Value> > &records)
+{
+    Tree tree;
+    vector<typename Tree::iterator> iterators;
+    uint64_t start = LatencyClock::now();
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        typename Tree::iterator *position = applyTraceRecord(tree, records[i], iterators);
+        if (position != NULL && *position != tree.end())
+        {
+            replaySink += (long)(*position)->second;
+        }
+    }
+    return LatencyClock::now() - start;
+}
+
+/**
+ * Replays records with every call, and every increment of a run, timed on
+ * its own.
+ */
+template <class Tree, class Key, class Value>
+static void replayTimed(const vector<TraceRecord<Key, Value> > &records, ReplayStats &stats)
+{
+    Tree tree;
+    vector<typename Tree::iterator> iterators;
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        const TraceRecord<Key, Value> &r = records[i];
+        if (r.op == TRACE_NEXT)
+        {
+            typename Tree::iterator &position = tracedIterator(tree, iterators, r.iterator);
+            for (uint64_t k = 0; k < r.count && position != tree.end(); ++k)
+            {
+                uint64_t start = LatencyClock::now();
+                ++position;
+                stats.next.record(LatencyClock::now() - start);
+            }
+            if (position != tree.end())
+            {
+                replaySink += (long)position->second;
+            }
+            continue;
+        }
+        uint64_t start = LatencyClock::now();
+        typename Tree::iterator *position = applyTraceRecord(tree, r, iterators);
+        uint64_t ticks = LatencyClock::now() - start;
+        switch (r.op)
+        {
+        case TRACE_INSERT:
+            stats.insert.record(ticks);
+            break;
+        case TRACE_REMOVE:
+            stats.remove.record(ticks);
+            break;
+        case TRACE_FIND:
+            stats.find.record(ticks);
+            break;
+        case TRACE_COPY:
+            stats.copy.record(ticks);
+            break;
+        default:
+            stats.begin.record(ticks);
+            break;
+        }
+        if (position != NULL && *position != tree.end())
+        {
+            replaySink += (long)(*position)->second;
+        }
+    }
+}
+
+/**
+ * Replays the trace on one tree type and prints its rows.
+ */
+template <class Tree, class Key, class Value>
+static void replayTree(const string &name, const vector<TraceRecord<Key, Value> > &records, uint64_t calls)
+{
+    double ms = (double)LatencyClock::toNanos(replayUntimed<Tree>(records)) / 1e6;
+    ReplayStats stats;
+    replayTimed<Tree>(records, stats);
+    printRow(name, "insert", stats.insert);
+    printRow(name, "remove", stats.remove);
+    printRow(name, "find", stats.find);
+    printRow(name, "begin", stats.begin);
+    printRow(name, "next", stats.next);
+    printRow(name, "copy", stats.copy);
+    cout << left << setw(10) << name << setw(8) << "all" << right << setw(12) << calls << fixed << setprecision(2)
+         << setw(10) << ms << " ms, " << (double)calls / ms / 1000.0 << " Mcalls/s" << endl;
+}
+
+/**
+ * Reads the whole trace into memory, so that reading it is not timed, and
+ * replays it on every tree named.
+ */
+template <class Key, class Value>
+static int replayAll(istream &in, const vector<string> &trees)
+{
+    TraceReader<Key, Value> reader(in);
+    vector<TraceRecord<Key, Value> > records;
+    TraceRecord<Key, Value> r;
+    uint64_t calls = 0;
+    while (reader.read(r))
+    {
+        records.push_back(r);
+        calls += r.count;
+    }
+    cout << records.size() << " records, " << calls << " calls (" << sizeof(Key) << "-byte keys, "
+         << sizeof(Value) << "-byte values)" << endl;
+    cout << left << setw(10) << "tree" << setw(8) << "op" << right << setw(12) << "count" << setw(10) << "mean"
+         << setw(10) << "p50" << setw(10) << "p99" << setw(10) << "p99.9" << setw(12) << "max" << "   (ns)" << endl;
+    for (size_t i = 0; i < trees.size(); ++i)
+    {
+        const string &t = trees[i];
+        if (t == "bst")
+        {
+            replayTree<BinarySearchTree<Key, Value> >(t, records, calls);
+        }
+        else if (t == "avl")
+        {
+            replayTree<AVLTree<Key, Value> >(t, records, calls);
+        }
+        else if (t == "rb")
+        {
+            replayTree<RedBlackTree<Key, Value> >(t, records, calls);
+        }
+        else if (t == "splay")
+        {
+            replayTree<SplayTree<Key, Value> >(t, records, calls);
+        }
+        else if (t == "wavl")
+        {
+            replayTree<WAVLTree<Key, Value> >(t, records, calls);
+        }
+        else if (t == "sg")
+        {
+            replayTree<ScapegoatTree<Key, Value> >(t, records, calls);
+        }
+        else if (t == "small")
+        {
+            replayTree<SmallAVLTree<Key, Value> >(t, records, calls);
+        }
+        else
+        {
+            cerr << "unknown tree " << t << endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Picks the key and value types matching the sizes in the trace's header.
+ */
+static int replayFile(const string &path, const vector<string> &trees)
+{
+    ifstream in(path.c_str(), ios::binary);
+    if (!in)
+    {
+        cerr << "cannot open " << path << endl;
+        return 1;
+    }
+    TraceHeader h = TraceHeader::read(in);
+    in.seekg(0);
+    if (h.keyBytes == 4 && h.valueBytes == 4)
+    {
+        return replayAll<int32_t, int32_t>(in, trees);
+    }
+    if (h.keyBytes == 4 && h.valueBytes == 8)
+    {
+        return replayAll<int32_t, int64_t>(in, trees);
+    }
+    if (h.keyBytes == 8 && h.valueBytes == 4)
+    {
+        return replayAll<int64_t, int32_t>(in, trees);
+    }
+    if (h.keyBytes == 8 && h.valueBytes == 8)
+    {
+        return replayAll<int64_t, int64_t>(in, trees);
+    }
+    cerr << path << ": cannot replay " << h.keyBytes << "-byte keys with " << h.valueBytes << "-byte values"
+         << endl;
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    string path;
+    vector<string> trees;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        if (arg == "-tree" && i + 1 < argc)
+        {
+            trees.push_back(argv[++i]);
+        }
+        else if (path.empty() && !arg.empty() && arg[0] != '-')
+        {
+            path = arg;
+        }
+        else
+        {
+            path.clear();
+            break;
+        }
+    }
+    if (path.empty())
+    {
+        cerr << "usage: " << argv[0] << " TRACE [-tree bst|avl|rb|splay|wavl|sg|small]..." << endl;
+        return 1;
+    }
+    if (trees.empty())
+    {
+        const char *all[] = {"bst", "avl", "rb", "splay", "wavl", "sg", "small"};
+        trees.assign(all, all + 7);
+    }
+
+    try
+    {
+        return replayFile(path, trees);
+    }
+    catch (const runtime_error &e)
+    {
+        cerr << path << ": " << e.what() << endl;
+        return 1;
+    }
+}
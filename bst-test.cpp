@@ -1,7 +1,23 @@
 #include <iostream>
 #include <map>
+#include <sstream>
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
 #include "bst.h"
 #include "avlbst.h"
+#include "rbbst.h"
+#include "splaybst.h"
+#include "wavlbst.h"
+#include "scapegoatbst.h"
+#include "indexavlbst.h"
+#include "staticavlbst.h"
+#include "smallavlbst.h"
+#include "augavlbst.h"
+#include "lazyavlbst.h"
+#include "intervalbst.h"
+#include "multimapbst.h"
+#include "trace_bst.h"
 
 using namespace std;
 
@@ -23,6 +39,16 @@ int main(int argc, char *argv[])
     else {
         cout << "Did not find b" << endl;
     }
+    cout << "Profile: ";
+    bt.profile().writeJson(cout);
+    cout << endl;
+    bt.insert(std::make_pair('c',3));
+    bt.insert(std::make_pair('d',4));
+    bt.rebalance();
+    cout << "Rebalanced height: " << bt.profile().maxPathLength << endl;
+    bt.pop_min();
+    bt.pop_max();
+    cout << "Popped to: " << bt.begin()->first << " .. " << bt.rbegin()->first << endl;
     cout << "Erasing b" << endl;
     bt.remove('b');
 
@@ -41,8 +67,337 @@ int main(int argc, char *argv[])
     else {
         cout << "Did not find b" << endl;
     }
+    const char batchKeys[] = {'b', 'z', 'a'};
+    AVLTree<char,int>::iterator batchOut[3];
+    at.find_batch(batchKeys, 3, batchOut);
+    cout << "Batch found: " << (batchOut[0] != at.end()) << (batchOut[1] != at.end()) << (batchOut[2] != at.end()) << endl;
+    cout << "Live nodes: " << at.memory_usage().liveNodes << endl;
+    at.upsert('a', [](int &v) { ++v; }, []() { return 1; });
+    at.upsert('d', [](int &v) { ++v; }, []() { return 1; });
+    at.modify('d', [](int &v) { v *= 10; });
+    cout << "Upserted a: " << at['a'] << " d: " << at['d'] << endl;
+    at.remove('d');
+    AVLTree<char,int>::iterator near = at.insert_near(at.find('b'), std::make_pair('c',3));
+    cout << "Finger found a: " << (at.find_from(near, 'a') != at.end()) << endl;
+    at.compact();
+    cout << "Compacted, found a: " << (at.find('a') != at.end()) << endl;
+    cout << "Validated: " << at.validate() << at.validate(2) << endl;
+    BinarySearchTree<char,int> &atBase = at;
+    try {
+        atBase.rebalance();
+        cout << "Rebalance through base: allowed" << endl;
+    }
+    catch(const std::logic_error &) {
+        cout << "Rebalance through base: refused, still valid " << at.validate() << endl;
+    }
+    cout << "Reverse:";
+    for(AVLTree<char,int>::reverse_iterator it = at.rbegin(); it != at.rend(); ++it) {
+        cout << " " << it->first;
+    }
+    AVLTree<char,int>::stack_cursor last = at.end_cursor();
+    --last;
+    cout << ", last by cursor: " << last->first << endl;
+    std::ostringstream dot, lines;
+    at.writeDot(dot);
+    at.writeJsonLines(lines, at.find('b'), 0);
+    string dotText = dot.str(), linesText = lines.str();
+    cout << "DOT lines: " << std::count(dotText.begin(), dotText.end(), '\n')
+         << ", JSON lines under b: " << std::count(linesText.begin(), linesText.end(), '\n') << endl;
+    AVLTree<double,signed char> tiny;
+    tiny.insert(std::make_pair(1e-9, 'x'));
+    std::ostringstream tinyLines;
+    tiny.writeJsonLines(tinyLines);
+    string tinyText = tinyLines.str();
+    cout << "Exported key and value: " << tinyText.substr(tinyText.find("\"key\""), 26) << endl;
     cout << "Erasing b" << endl;
     at.remove('b');
 
+    // Red-Black Tree Tests
+    RedBlackTree<char,int> rt;
+    rt.insert(std::make_pair('a',1));
+    rt.insert(std::make_pair('b',2));
+    rt.insert(std::make_pair('c',3));
+
+    cout << "\nRedBlackTree contents:" << endl;
+    for(RedBlackTree<char,int>::iterator it = rt.begin(); it != rt.end(); ++it) {
+        cout << it->first << " " << it->second << endl;
+    }
+    if(rt.find('b') != rt.end()) {
+        cout << "Found b" << endl;
+    }
+    else {
+        cout << "Did not find b" << endl;
+    }
+    cout << "Erasing b" << endl;
+    rt.remove('b');
+
+    // Splay Tree Tests
+    SplayTree<char,int> st;
+    st.insert(std::make_pair('a',1));
+    st.insert(std::make_pair('b',2));
+    st.insert(std::make_pair('c',3));
+
+    cout << "\nSplayTree contents:" << endl;
+    for(SplayTree<char,int>::iterator it = st.begin(); it != st.end(); ++it) {
+        cout << it->first << " " << it->second << endl;
+    }
+    if(st.find('a') != st.end()) {
+        cout << "Found a" << endl;
+    }
+    else {
+        cout << "Did not find a" << endl;
+    }
+    cout << "Erasing b" << endl;
+    st.remove('b');
+
+    // WAVL Tree Tests
+    WAVLTree<char,int> wt;
+    wt.insert(std::make_pair('a',1));
+    wt.insert(std::make_pair('b',2));
+    wt.insert(std::make_pair('c',3));
+
+    cout << "\nWAVLTree contents:" << endl;
+    for(WAVLTree<char,int>::iterator it = wt.begin(); it != wt.end(); ++it) {
+        cout << it->first << " " << it->second << endl;
+    }
+    cout << "Erasing b" << endl;
+    wt.remove('b');
+    cout << "Rotations: " << wt.getStats().insertRotations + wt.getStats().removeRotations << endl;
+
+    // Scapegoat Tree Tests
+    ScapegoatTree<char,int> sgt;
+    for(char c = 'a'; c <= 'g'; ++c) {
+        sgt.insert(std::make_pair(c, c - 'a'));
+    }
+
+    cout << "\nScapegoatTree contents:" << endl;
+    for(ScapegoatTree<char,int>::iterator it = sgt.begin(); it != sgt.end(); ++it) {
+        cout << it->first << " " << it->second << endl;
+    }
+    cout << "Erasing d" << endl;
+    sgt.remove('d');
+    cout << "Size: " << sgt.size() << ", rebuilds: " << sgt.getRebuilds() << endl;
+    BinarySearchTree<char,int> &sgBase = sgt;
+    sgBase.clear();
+    sgBase.insert(std::make_pair('z', 0));
+    cout << "Size after clearing through the base: " << sgt.size() << endl;
+
+    // Indexed AVL Tree Tests
+    IndexedAVLTree<char,int> it32;
+    it32.insert(std::make_pair('a',1));
+    it32.insert(std::make_pair('b',2));
+    it32.insert(std::make_pair('c',3));
+
+    cout << "\nIndexedAVLTree contents:" << endl;
+    for(IndexedAVLTree<char,int>::iterator it = it32.begin(); it != it32.end(); ++it) {
+        cout << it->first << " " << it->second << endl;
+    }
+    cout << "Erasing b" << endl;
+    it32.remove('b');
+    it32.insert(std::make_pair('d',4));
+    cout << "Size: " << it32.size() << ", slots: " << it32.capacity() << ", balanced: " << it32.isBalanced() << endl;
+    IndexedAVLTree<char,int> it32Copy(it32);
+    it32.remove('a');
+    it32Copy.print();
+    IndexedAVLTree<int,int> grown;
+    for(int i = 0; i < 40; ++i) {
+        grown.insert(std::make_pair(i, i));
+    }
+    cout << "Slots for 40: " << grown.capacity();
+    for(int i = 40; i < 1100; ++i) {
+        grown.insert(std::make_pair(i, i));
+    }
+    cout << ", for 1100: " << grown.capacity() << ", 1099 found: " << grown.find(1099)->second
+         << ", balanced: " << grown.isBalanced() << endl;
+
+    // Static AVL Tree Tests
+    StaticAVLTree<char,int,3> fixed;
+    fixed.insert(std::make_pair('a',1));
+    fixed.insert(std::make_pair('b',2));
+    fixed.insert(std::make_pair('c',3));
+
+    cout << "\nStaticAVLTree contents:" << endl;
+    for(StaticAVLTree<char,int,3>::iterator it = fixed.begin(); it != fixed.end(); ++it) {
+        cout << it->first << " " << it->second << endl;
+    }
+    cout << "Full: " << fixed.full() << endl;
+    cout << "Erasing b" << endl;
+    fixed.remove('b');
+    fixed.insert(std::make_pair('d',4));
+    StaticAVLTree<char,int,3> fixedCopy(fixed);
+    cout << "Size: " << fixedCopy.size() << ", capacity: " << fixedCopy.capacity() << ", balanced: " << fixedCopy.isBalanced() << endl;
+    fixedCopy.upsert('c', [](int &v) { ++v; }, []() { return 0; });
+    fixedCopy.modify('d', [](int &v) { v *= 10; });
+    cout << "Bounds: " << fixedCopy.lower_bound('b')->first << " " << fixedCopy.upper_bound('c')->first
+         << ", last: " << fixedCopy.rbegin()->first << " " << fixedCopy.rbegin()->second
+         << ", from a: " << fixedCopy.find_from(fixedCopy.begin(), 'd')->first << endl;
+    StaticAVLTree<char,int,3>::iterator step = fixedCopy.begin();
+    char before = (step++)->first;
+    char after = (step--)->first;
+    cout << "Postfix steps: " << before << " " << after << " " << step->first << endl;
+    fixedCopy.pop_min();
+    fixedCopy.pop_max();
+    cout << "Popped to: " << fixedCopy.begin()->first << " " << fixedCopy.begin()->second << ", count c: " << fixedCopy.count('c') << endl;
+
+    // Small AVL Tree Tests
+    SmallAVLTree<char,int,2> small;
+    small.insert(std::make_pair('b',2));
+    small.insert(std::make_pair('a',1));
+    SmallAVLTree<char,int,2>::iterator smallFirst = small.begin();
+    cout << "\nSmallAVLTree inline: " << small.inlineNodes() << ", allocations: " << small.memory_usage().allocations << endl;
+    small.insert(std::make_pair('c',3));
+    small.remove('b');
+    small.insert(std::make_pair('d',4));
+    for(SmallAVLTree<char,int,2>::iterator it = small.begin(); it != small.end(); ++it) {
+        cout << it->first << " " << it->second << endl;
+    }
+    cout << "Inline: " << small.inlineNodes() << ", allocations: " << small.memory_usage().allocations << ", first still: " << smallFirst->first << ", valid: " << small.validate() << endl;
+
+    // Augmented AVL Tree Tests
+    AugmentedAVLTree<char,int> sumt;
+    AugmentedAVLTree<char,int,MaxMonoid<int> > maxt;
+    for(char c = 'a'; c <= 'j'; ++c) {
+        sumt.insert(std::make_pair(c, c - 'a'));
+        maxt.insert(std::make_pair(c, (c - 'a') % 4));
+    }
+    sumt.remove('e');
+
+    cout << "\nAugmentedAVLTree aggregates:" << endl;
+    cout << "Sum b..f: " << sumt.aggregate('b', 'f') << ", sum all: " << sumt.aggregateAll() << endl;
+    cout << "Max a..c: " << maxt.aggregate('a', 'c') << endl;
+
+    // Lazy AVL Tree Tests
+    LazyAVLTree<char,int> lt;
+    for(char c = 'a'; c <= 'j'; ++c) {
+        lt.insert(std::make_pair(c, 1));
+    }
+    lt.rangeAdd('c', 'h', 10);
+    lt.rangeAssign('g', 'j', 2);
+    cout << "\nLazyAVLTree after range updates:" << endl;
+    for(LazyAVLTree<char,int>::iterator it = lt.begin(); it != lt.end(); ++it) {
+        cout << it->first << " " << it->second << endl;
+    }
+    cout << "Sum a..j: " << lt.aggregate('a', 'j') << endl;
+    LazyAVLTree<int,int> steps;
+    for(int i = 1; i <= 31; ++i) {
+        steps.insert(std::make_pair(i, 0));
+    }
+    steps.rangeAdd(1, 31, 5);
+    LazyAVLTree<int,int>::iterator mid = steps.find(16);
+    ++mid;
+    cout << "After 16: " << mid->first << " " << mid->second;
+    --mid;
+    --mid;
+    cout << ", before 16: " << mid->first << " " << mid->second << endl;
+    steps.rangeAdd(10, 20, 1);
+    AVLTree<int,int> &asBase = steps;
+    asBase.insert(std::make_pair(32, 0));
+    asBase.upsert(15, [](int &v) { v *= 2; }, []() { return 0; });
+    cout << "Through AVLTree&: 14 " << asBase.find(14)->second << ", 15 " << asBase[15]
+         << ", 32 " << (--asBase.end())->second << ", sum " << steps.aggregate(1, 32) << endl;
+
+    // Interval Tree Tests
+    IntervalTree<int,char> ivt;
+    ivt.insert(1, 5, 'a');
+    ivt.insert(3, 4, 'b');
+    ivt.insert(6, 9, 'c');
+    ivt.insert(8, 12, 'd');
+    vector<IntervalTree<int,char>::iterator> hits;
+    ivt.overlapping(4, 7, hits);
+    cout << "\nIntervalTree overlaps of [4,7]:" << endl;
+    for(size_t i = 0; i < hits.size(); ++i) {
+        cout << hits[i]->first << " " << hits[i]->second << endl;
+    }
+    hits.clear();
+    ivt.stab(8, hits);
+    cout << "Stabbing 8: " << hits.size() << ", any in [13,20]: " << ivt.overlapsAny(13, 20) << endl;
+
+    // Multimap Tests
+    Multimap<char,int> mm;
+    mm.insert(std::make_pair('b', 1));
+    mm.insert(std::make_pair('a', 2));
+    mm.insert(std::make_pair('b', 3));
+    mm.insert(std::make_pair('c', 4));
+    mm.insert(std::make_pair('b', 5));
+    cout << "\nMultimap values of b:" << endl;
+    std::pair<Multimap<char,int>::iterator, Multimap<char,int>::iterator> range = mm.equal_range('b');
+    for(Multimap<char,int>::iterator it = range.first; it != range.second; ++it) {
+        cout << it->first << " " << it->second << endl;
+    }
+    Multimap<char,int>::iterator second = mm.erase(++mm.lower_bound('b'));
+    cout << "After erasing one b, next is " << second->second << ", b values:";
+    for(Multimap<char,int>::iterator it = mm.lower_bound('b'); it != mm.upper_bound('b'); ++it) {
+        cout << " " << it->second;
+    }
+    cout << endl;
+    mm.remove('b');
+    cout << "Count of b: " << mm.count('b') << ", count of c: " << mm.count('c') << endl;
+
+    // Trace Tests
+    stringstream trace;
+    TraceWriter<char,int> writer(trace);
+    TracedTree<char,int> traced;
+    traced.startTrace(&writer);
+    traced.insert(std::make_pair('b',2));
+    traced.insert(std::make_pair('a',1));
+    traced.insert(std::make_pair('c',3));
+    traced.remove('a');
+    int scanned = 0;
+    for(TracedTree<char,int>::iterator it = traced.find('b'); it != traced.end(); ++it) {
+        ++scanned;
+    }
+    traced.stopTrace();
+
+    RedBlackTree<char,int> replayed;
+    std::vector<RedBlackTree<char,int>::iterator> replayedIterators;
+    TraceReader<char,int> reader(trace);
+    TraceRecord<char,int> record;
+    while(reader.read(record)) {
+        applyTraceRecord(replayed, record, replayedIterators);
+    }
+    cout << "\nScanned " << scanned << ", replayed " << writer.records() << " records:" << endl;
+    for(RedBlackTree<char,int>::iterator it = replayed.begin(); it != replayed.end(); ++it) {
+        cout << it->first << " " << it->second << endl;
+    }
+
+    // an iterator kept across a find and remove elsewhere replays from its own position
+    stringstream trace2;
+    TraceWriter<int,int> writer2(trace2);
+    TracedTree<int,int> traced2;
+    for(int k = 1; k <= 8; ++k) {
+        traced2.insert(std::make_pair(k, k * 10));
+    }
+    traced2.startTrace(&writer2);
+    TracedTree<int,int>::iterator kept = traced2.find(3);
+    traced2.find(7);
+    traced2.remove(7);
+    ++kept;
+    TracedTree<int,int>::iterator copied = kept;
+    ++copied;
+    ++kept;
+    ++kept;
+    traced2.stopTrace();
+    AVLTree<int,int> replayed2;
+    for(int k = 1; k <= 8; ++k) {
+        replayed2.insert(std::make_pair(k, k * 10));
+    }
+    std::vector<AVLTree<int,int>::iterator> replayedIterators2;
+    TraceReader<int,int> reader2(trace2);
+    TraceRecord<int,int> record2;
+    uint32_t keptId = 0, copiedId = 0;
+    bool foundKept = false;
+    while(reader2.read(record2)) {
+        applyTraceRecord(replayed2, record2, replayedIterators2);
+        if(record2.op == TRACE_FIND && !foundKept) {
+            keptId = record2.iterator;
+            foundKept = true;
+        }
+        else if(record2.op == TRACE_COPY) {
+            copiedId = record2.iterator;
+        }
+    }
+    cout << "Kept at " << kept->first << ", copy at " << copied->first << "; replayed "
+         << replayedIterators2[keptId]->first << ", copy " << replayedIterators2[copiedId]->first << endl;
+
     return 0;
 }
@@ -3,8 +3,23 @@
 
 #include <iostream>
 #include <exception>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <cstdlib>
+#include <iterator>
+#include <stdexcept>
 #include <utility>
+#include <vector>
+#include "node_resource.h"
+#include "tree_profile.h"
+
+// Prefetch hint used by the batched lookups; a no-op where unsupported.
+#if defined(__GNUC__)
+#define BST_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define BST_PREFETCH(addr) ((void)0)
+#endif
 
 /**
  * A templated class for a Node in a search tree.
@@ -183,6 +198,20 @@ void Node<Key, Value>::setValue(const Value &value)
   ---------------------------------------
 */
 
+/**
+ * Node memory accounting reported by BinarySearchTree::memory_usage().
+ * bytesInUse counts everything the tree holds from its NodeResource,
+ * including blocks such as the one AVLTree::compact() builds.
+ */
+struct MemoryUsage
+{
+    size_t nodeBytes;     // size of one node of this tree
+    size_t liveNodes;     // nodes currently in the tree
+    size_t bytesInUse;    // bytes currently allocated from the resource
+    size_t allocations;   // allocate() calls made so far
+    size_t deallocations; // deallocate() calls made so far
+};
+
 /**
  * A templated unbalanced binary search tree.
  */
@@ -191,24 +220,42 @@ class BinarySearchTree
 {
 public:
     BinarySearchTree();                                                   // TODO
+    explicit BinarySearchTree(NodeResource *resource);
     virtual ~BinarySearchTree();                                          // TODO
     virtual void insert(const std::pair<const Key, Value> &keyValuePair); // TODO
     virtual void remove(const Key &key);                                  // TODO
-    void clear();                                                         // TODO
+    void pop_min();
+    void pop_max();
+    virtual void clear();                                                 // TODO
     bool isBalanced() const;                                              // TODO
+    void rebalance();
+    void setAutoRebalance(double c);
     void print() const;
     bool empty() const;
+    MemoryUsage memory_usage() const;
+    TreeProfile profile() const;
+    void writeDot(std::ostream &out, size_t maxDepth = (size_t)-1) const;
+    void writeJsonLines(std::ostream &out, size_t maxDepth = (size_t)-1) const;
 
     template <typename PPKey, typename PPValue>
     friend void prettyPrintBST(BinarySearchTree<PPKey, PPValue> &tree);
 
 public:
+    class const_iterator;
+
     /**
      * An internal iterator class for traversing the contents of the BST.
+     * It is bidirectional: decrementing end() reaches the largest item.
      */
     class iterator // TODO
     {
     public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef std::pair<const Key, Value> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef std::pair<const Key, Value> *pointer;
+        typedef std::pair<const Key, Value> &reference;
+
         iterator();
 
         std::pair<const Key, Value> &operator*() const;
@@ -218,17 +265,125 @@ public:
         bool operator!=(const iterator &rhs) const;
 
         iterator &operator++();
+        iterator operator++(int);
+        iterator &operator--();
+        iterator operator--(int);
 
     protected:
         friend class BinarySearchTree<Key, Value>;
-        iterator(Node<Key, Value> *ptr);
+        friend class const_iterator;
+        iterator(Node<Key, Value> *ptr, const BinarySearchTree<Key, Value> *tree);
         Node<Key, Value> *current_;
+        const BinarySearchTree<Key, Value> *tree_; // for stepping back from end()
+    };
+
+    /**
+     * The read-only counterpart of iterator, which converts to it.
+     */
+    class const_iterator
+    {
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef std::pair<const Key, Value> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const std::pair<const Key, Value> *pointer;
+        typedef const std::pair<const Key, Value> &reference;
+
+        const_iterator();
+        const_iterator(const iterator &it);
+
+        const std::pair<const Key, Value> &operator*() const;
+        const std::pair<const Key, Value> *operator->() const;
+
+        // non-members, so that an iterator converts on either side
+        friend bool operator==(const const_iterator &lhs, const const_iterator &rhs)
+        {
+            return lhs.current_ == rhs.current_;
+        }
+        friend bool operator!=(const const_iterator &lhs, const const_iterator &rhs)
+        {
+            return lhs.current_ != rhs.current_;
+        }
+
+        const_iterator &operator++();
+        const_iterator operator++(int);
+        const_iterator &operator--();
+        const_iterator operator--(int);
+
+    protected:
+        friend class BinarySearchTree<Key, Value>;
+        const Node<Key, Value> *current_;
+        const BinarySearchTree<Key, Value> *tree_;
+    };
+
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    /**
+     * An in-order cursor that keeps the nodes from the root down to its item
+     * on a stack and steps with child links alone, never reading a parent
+     * link. It is bidirectional like iterator, but any insert or remove
+     * invalidates it, and copying it copies the stack.
+     */
+    class stack_cursor
+    {
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef std::pair<const Key, Value> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef std::pair<const Key, Value> *pointer;
+        typedef std::pair<const Key, Value> &reference;
+
+        stack_cursor();
+
+        std::pair<const Key, Value> &operator*() const;
+        std::pair<const Key, Value> *operator->() const;
+
+        bool operator==(const stack_cursor &rhs) const;
+        bool operator!=(const stack_cursor &rhs) const;
+
+        stack_cursor &operator++();
+        stack_cursor operator++(int);
+        stack_cursor &operator--();
+        stack_cursor operator--(int);
+
+    protected:
+        friend class BinarySearchTree<Key, Value>;
+        explicit stack_cursor(const BinarySearchTree<Key, Value> *tree);
+        void descend(Node<Key, Value> *n, bool leftward);
+        void climb(bool fromLeft);
+        std::vector<Node<Key, Value> *> path_; // root first; empty at the end
+        Node<Key, Value> *root_;
+        const BinarySearchTree<Key, Value> *tree_; // for pushing pending updates
     };
 
 public:
     iterator begin() const;
     iterator end() const;
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+    reverse_iterator rbegin() const;
+    reverse_iterator rend() const;
+    const_reverse_iterator crbegin() const;
+    const_reverse_iterator crend() const;
+    stack_cursor begin_cursor() const;
+    stack_cursor end_cursor() const;
     iterator find(const Key &key) const;
+    void find_batch(const Key *keys, size_t count, iterator *out) const;
+    void find_batch(const std::vector<Key> &keys, std::vector<iterator> &out) const;
+    iterator find_from(const iterator &hint, const Key &key) const;
+    iterator lower_bound(const Key &key) const;
+    iterator upper_bound(const Key &key) const;
+    std::pair<iterator, iterator> equal_range(const Key &key) const;
+    size_t count(const Key &key) const;
+    TreeProfile profile(const iterator &subtree) const;
+    void writeDot(std::ostream &out, const iterator &subtree, size_t maxDepth = (size_t)-1) const;
+    void writeJsonLines(std::ostream &out, const iterator &subtree, size_t maxDepth = (size_t)-1) const;
+    iterator insert_near(const iterator &hint, const std::pair<const Key, Value> &keyValuePair);
+    template <typename Update, typename Make>
+    iterator upsert(const Key &key, Update fnIfPresent, Make makeIfAbsent);
+    template <typename Update>
+    bool modify(const Key &key, Update fn);
     Value &operator[](const Key &key);
     Value const &operator[](const Key &key) const;
 
@@ -236,6 +391,7 @@ protected:
     // Mandatory helper functions
     Node<Key, Value> *internalFind(const Key &k) const;              // TODO
     Node<Key, Value> *getSmallestNode() const;                       // TODO
+    Node<Key, Value> *getLargestNode() const;
     static Node<Key, Value> *predecessor(Node<Key, Value> *current); // TODO
     // Note:  static means these functions don't have a "this" pointer
     //        and instead just use the input argument.
@@ -247,10 +403,52 @@ protected:
     // Add helper functions here
     int calculateHeight(Node<Key, Value> *r) const;
     void deleteNode(Node<Key, Value> *c);
+    virtual void removeNode(Node<Key, Value> *n);
+    virtual void destroyNode(Node<Key, Value> *n);
+    template <typename NodeType>
+    NodeType *createNode(const Key &key, const Value &value, NodeType *parent);
+    void *allocateBytes(size_t bytes, size_t align);
+    void releaseBytes(void *p, size_t bytes, size_t align);
+    virtual void valueChanged(Node<Key, Value> *n);
+    virtual bool keysUnique() const;
+    virtual bool relinkable() const;
+    iterator iteratorAt(Node<Key, Value> *n) const;
+    static Node<Key, Value> *nodeAt(const iterator &it);
+    static TreeProfile profileFrom(Node<Key, Value> *top);
+    void rebalanceSubtree(Node<Key, Value> *r);
+    bool rebalanceIfDeep(Node<Key, Value> *n, double limit, double alpha);
+    void rotateLeftAt(Node<Key, Value> *x);
+    void rotateRightAt(Node<Key, Value> *x);
+    static size_t countNodes(Node<Key, Value> *r);
+    template <typename Visit>
+    static void walkPreorder(Node<Key, Value> *top, size_t maxDepth, Visit visit);
+    static void writeDotFrom(std::ostream &out, Node<Key, Value> *top, size_t maxDepth);
+    static void writeJsonLinesFrom(std::ostream &out, Node<Key, Value> *top, size_t maxDepth);
+    Node<Key, Value> *fingerStart(Node<Key, Value> *hint, const Key &key) const;
+    virtual Node<Key, Value> *attachLeaf(Node<Key, Value> *parent, const std::pair<const Key, Value> &keyValuePair);
+    void noteLinked(Node<Key, Value> *n);
+    void noteUnlinking(Node<Key, Value> *n);
+    void findExtremes();
+    virtual void pushPending(Node<Key, Value> *n) const;
+    void pushOnDescent(Node<Key, Value> *n) const;
+    void pushSubtree(Node<Key, Value> *top, size_t maxDepth) const;
+    Node<Key, Value> *nextNode(Node<Key, Value> *n) const;
+    Node<Key, Value> *prevNode(Node<Key, Value> *n) const;
 
 protected:
     Node<Key, Value> *root_;
     // You should not need other data members
+    NodeResource *resource_;
+    MemoryUsage usage_;
+    size_t nodeAlign_;
+    double autoRebalance_; // c in the depth limit c*log2(n), or 0 for none
+    // the first and last nodes in key order (NULL when empty), kept current
+    // by every link and unlink so that neither end needs a descent
+    Node<Key, Value> *leftmost_;
+    Node<Key, Value> *rightmost_;
+    // set by trees that leave updates pending in nodes for their children;
+    // every descent and iterator step then calls pushPending() on its way
+    bool pushesPending_;
 };
 
 /*
@@ -260,12 +458,13 @@ Begin implementations for the BinarySearchTree::iterator class.
 */
 
 /**
-tializes an iterator with a given node pointer.
+tializes an iterator with a given node pointer in the given tree.
  */
 template <class Key, class Value>
-BinarySearchTree<Key, Value>::iterator::iterator(Node<Key, Value> *ptr)
+BinarySearchTree<Key, Value>::iterator::iterator(Node<Key, Value> *ptr, const BinarySearchTree<Key, Value> *tree)
 {
     current_ = ptr;
+    tree_ = tree;
 }
 
 /**
@@ -275,6 +474,7 @@ template <class Key, class Value>
 BinarySearchTree<Key, Value>::iterator::iterator()
 {
     current_ = NULL;
+    tree_ = NULL;
 }
 
 /**
@@ -329,16 +529,263 @@ template <class Key, class Value>
 typename BinarySearchTree<Key, Value>::iterator &
 BinarySearchTree<Key, Value>::iterator::operator++()
 {
-    current_ = successor(current_);
+    current_ = tree_->nextNode(current_);
+    return *this;
+}
+
+template <class Key, class Value>
+typename BinarySearchTree<Key, Value>::iterator
+BinarySearchTree<Key, Value>::iterator::operator++(int)
+{
+    iterator before = *this;
+    ++*this;
+    return before;
+}
+
+/**
+ * Moves the iterator back one item in order; from end() it moves to the
+ * largest item.
+ */
+template <class Key, class Value>
+typename BinarySearchTree<Key, Value>::iterator &
+BinarySearchTree<Key, Value>::iterator::operator--()
+{
+    current_ = tree_->prevNode(current_);
     return *this;
 }
 
+template <class Key, class Value>
+typename BinarySearchTree<Key, Value>::iterator
+BinarySearchTree<Key, Value>::iterator::operator--(int)
+{
+    iterator before = *this;
+    --*this;
+    return before;
+}
+
 /*
 -------------------------------------------------------------
 End implementations for the BinarySearchTree::iterator class.
 -------------------------------------------------------------
 */
 
+/*
+-------------------------------------------------------------------
+Begin implementations for the BinarySearchTree::const_iterator class.
+-------------------------------------------------------------------
+*/
+
+template <class Key, class Value>
+BinarySearchTree<Key, Value>::const_iterator::const_iterator() : current_(NULL), tree_(NULL)
+{
+}
+
+/**
+ * Converts an iterator to a read-only one at the same item.
+ */
+template <class Key, class Value>
+BinarySearchTree<Key, Value>::const_iterator::const_iterator(const iterator &it)
+    : current_(it.current_), tree_(it.tree_)
+{
+}
+
+template <class Key, class Value>
+const std::pair<const Key, Value> &BinarySearchTree<Key, Value>::const_iterator::operator*() const
+{
+    return current_->getItem();
+}
+
+template <class Key, class Value>
+const std::pair<const Key, Value> *BinarySearchTree<Key, Value>::const_iterator::operator->() const
+{
+    return &(current_->getItem());
+}
+
+template <class Key, class Value>
+typename BinarySearchTree<Key, Value>::const_iterator &BinarySearchTree<Key, Value>::const_iterator::operator++()
+{
+    current_ = tree_->nextNode(const_cast<Node<Key, Value> *>(current_));
+    return *this;
+}
+
+template <class Key, class Value>
+typename BinarySearchTree<Key, Value>::const_iterator BinarySearchTree<Key, Value>::const_iterator::operator++(int)
+{
+    const_iterator before = *this;
+    ++*this;
+    return before;
+}
+
+template <class Key, class Value>
+typename BinarySearchTree<Key, Value>::const_iterator &BinarySearchTree<Key, Value>::const_iterator::operator--()
+{
+    current_ = tree_->prevNode(const_cast<Node<Key, Value> *>(current_));
+    return *this;
+}
+
+template <class Key, class Value>
+typename BinarySearchTree<Key, Value>::const_iterator BinarySearchTree<Key, Value>::const_iterator::operator--(int)
+{
+    const_iterator before = *this;
+    --*this;
+    return before;
+}
+
+/*
+-----------------------------------------------------------------
+End implementations for the BinarySearchTree::const_iterator class.
+-----------------------------------------------------------------
+*/
+
+/*
+------------------------------------------------------------------
+Begin implementations for the BinarySearchTree::stack_cursor class.
+------------------------------------------------------------------
+*/
+
+/**
+ * A cursor at the end of no tree, which only compares equal to others at
+ * the end.
+ */
+template <class Key, class Value>
+BinarySearchTree<Key, Value>::stack_cursor::stack_cursor() : root_(NULL), tree_(NULL)
+{
+}
+
+/**
+ * A cursor at the end of tree; begin_cursor() then steps it onto the first
+ * item.
+ */
+template <class Key, class Value>
+BinarySearchTree<Key, Value>::stack_cursor::stack_cursor(const BinarySearchTree<Key, Value> *tree)
+    : root_(tree->root_), tree_(tree)
+{
+}
+
+template <class Key, class Value>
+std::pair<const Key, Value> &BinarySearchTree<Key, Value>::stack_cursor::operator*() const
+{
+    return path_.back()->getItem();
+}
+
+template <class Key, class Value>
+std::pair<const Key, Value> *BinarySearchTree<Key, Value>::stack_cursor::operator->() const
+{
+    return &(path_.back()->getItem());
+}
+
+/**
+ * Cursors are equal when they stand on the same item or are both at the end.
+ */
+template <class Key, class Value>
+bool BinarySearchTree<Key, Value>::stack_cursor::operator==(const stack_cursor &rhs) const
+{
+    return (path_.empty() ? NULL : path_.back()) == (rhs.path_.empty() ? NULL : rhs.path_.back());
+}
+
+template <class Key, class Value>
+bool BinarySearchTree<Key, Value>::stack_cursor::operator!=(const stack_cursor &rhs) const
+{
+    return !(*this == rhs);
+}
+
+/**
+ * Steps to the next item: the leftmost node of the right subtree if there
+ * is one, else the nearest ancestor reached from its left side.
+ */
+template <class Key, class Value>
+typename BinarySearchTree<Key, Value>::stack_cursor &BinarySearchTree<Key, Value>::stack_cursor::operator++()
+{
+    Node<Key, Value> *n = path_.back();
+    if (n->getRight() != NULL)
+    {
+        descend(n->getRight(), true);
+    }
+    else
+    {
+        climb(true);
+    }
+    return *this;
+}
+
+template <class Key, class Value>
+typename BinarySearchTree<Key, Value>::stack_cursor BinarySearchTree<Key, Value>::stack_cursor::operator++(int)
+{
+    stack_cursor before = *this;
+    ++*this;
+    return before;
+}
+
+/**
+ * Steps to the previous item, the mirror image of operator++; from the end
+ * it moves to the largest item.
+ */
+template <class Key, class Value>
+typename BinarySearchTree<Key, Value>::stack_cursor &BinarySearchTree<Key, Value>::stack_cursor::operator--()
+{
+    if (path_.empty())
+    {
+        if (root_ != NULL)
+        {
+            descend(root_, false);
+        }
+    }
+    else if (path_.back()->getLeft() != NULL)
+    {
+        descend(path_.back()->getLeft(), false);
+    }
+    else
+    {
+        climb(false);
+    }
+    return *this;
+}
+
+template <class Key, class Value>
+typename BinarySearchTree<Key, Value>::stack_cursor BinarySearchTree<Key, Value>::stack_cursor::operator--(int)
+{
+    stack_cursor before = *this;
+    --*this;
+    return before;
+}
+
+/**
+ * Pushes n and then its left (or, with leftward false, right) children down
+ * to the end of that spine. Every node on the stack has had its pending
+ * updates pushed, so the items below it read current values.
+ */
+template <class Key, class Value>
+void BinarySearchTree<Key, Value>::stack_cursor::descend(Node<Key, Value> *n, bool leftward)
+{
+    while (n != NULL)
+    {
+        tree_->pushOnDescent(n);
+        path_.push_back(n);
+        n = leftward ? n->getLeft() : n->getRight();
+    }
+}
+
+/**
+ * Pops nodes until the top was entered through its left child (or, with
+ * fromLeft false, its right child), or until the stack runs out at the end.
+ */
+template <class Key, class Value>
+void BinarySearchTree<Key, Value>::stack_cursor::climb(bool fromLeft)
+{
+    Node<Key, Value> *child;
+    do
+    {
+        child = path_.back();
+        path_.pop_back();
+    } while (!path_.empty() && (fromLeft ? path_.back()->getRight() : path_.back()->getLeft()) == child);
+}
+
+/*
+----------------------------------------------------------------
+End implementations for the BinarySearchTree::stack_cursor class.
+----------------------------------------------------------------
+*/
+
 /*
 -----------------------------------------------------
 Begin implementations for the BinarySearchTree class.
@@ -352,6 +799,30 @@ template <class Key, class Value>
 BinarySearchTree<Key, Value>::BinarySearchTree()
 {
     root_ = NULL;
+    resource_ = NodeResource::newDelete();
+    usage_ = MemoryUsage();
+    nodeAlign_ = 0;
+    autoRebalance_ = 0;
+    leftmost_ = NULL;
+    rightmost_ = NULL;
+    pushesPending_ = false;
+}
+
+/**
+ * Constructor for a tree whose nodes are allocated from resource, which must
+ * outlive the tree.
+ */
+template <class Key, class Value>
+BinarySearchTree<Key, Value>::BinarySearchTree(NodeResource *resource)
+{
+    root_ = NULL;
+    resource_ = resource;
+    usage_ = MemoryUsage();
+    nodeAlign_ = 0;
+    autoRebalance_ = 0;
+    leftmost_ = NULL;
+    rightmost_ = NULL;
+    pushesPending_ = false;
 }
 
 template <typename Key, typename Value>
@@ -369,21 +840,52 @@ bool BinarySearchTree<Key, Value>::empty() const
     return root_ == NULL;
 }
 
+/**
+ * Returns how much node memory the tree holds and how often it has gone to
+ * its resource, so the per-entry overhead of each variant can be compared.
+ */
+template <class Key, class Value>
+MemoryUsage BinarySearchTree<Key, Value>::memory_usage() const
+{
+    return usage_;
+}
+
+/**
+ * Returns the shape of the whole tree; see TreeProfile.
+ */
+template <typename Key, typename Value>
+TreeProfile BinarySearchTree<Key, Value>::profile() const
+{
+    return profileFrom(root_);
+}
+
+/**
+ * Returns the shape of the subtree rooted at the item subtree points to,
+ * with depths counted from that item (an empty profile for end()).
+ */
+template <typename Key, typename Value>
+TreeProfile BinarySearchTree<Key, Value>::profile(const iterator &subtree) const
+{
+    return profileFrom(subtree.current_);
+}
+
 template <typename Key, typename Value>
 void BinarySearchTree<Key, Value>::print() const
 {
+    pushSubtree(root_, (size_t)-1);
     printRoot(root_);
     std::cout << "\n";
 }
 
 /**
- * Returns an iterator to the "smallest" item in the tree
+ * Returns an iterator to the "smallest" item in the tree, in O(1) (O(log n)
+ * in a tree with pending updates, which descends to it from the root)
  */
 template <class Key, class Value>
 typename BinarySearchTree<Key, Value>::iterator
 BinarySearchTree<Key, Value>::begin() const
 {
-    BinarySearchTree<Key, Value>::iterator begin(getSmallestNode());
+    BinarySearchTree<Key, Value>::iterator begin(getSmallestNode(), this);
     return begin;
 }
 
@@ -394,272 +896,1046 @@ template <class Key, class Value>
 typename BinarySearchTree<Key, Value>::iterator
 BinarySearchTree<Key, Value>::end() const
 {
-    BinarySearchTree<Key, Value>::iterator end(NULL);
+    BinarySearchTree<Key, Value>::iterator end(NULL, this);
     return end;
 }
 
 /**
- * Returns an iterator to the item with the given key, k
- * or the end iterator if k does not exist in the tree
+ * Read-only versions of begin() and end()
  */
 template <class Key, class Value>
-typename BinarySearchTree<Key, Value>::iterator
-BinarySearchTree<Key, Value>::find(const Key &k) const
+typename BinarySearchTree<Key, Value>::const_iterator
+BinarySearchTree<Key, Value>::cbegin() const
 {
-    Node<Key, Value> *curr = internalFind(k);
-    BinarySearchTree<Key, Value>::iterator it(curr);
-    return it;
+    return begin();
+}
+
+template <class Key, class Value>
+typename BinarySearchTree<Key, Value>::const_iterator
+BinarySearchTree<Key, Value>::cend() const
+{
+    return end();
 }
 
 /**
- * @precondition The key exists in the map
- * Returns the value associated with the key
+ * Returns a reverse iterator to the largest item in the tree, in O(1)
  */
 template <class Key, class Value>
-Value &BinarySearchTree<Key, Value>::operator[](const Key &key)
+typename BinarySearchTree<Key, Value>::reverse_iterator
+BinarySearchTree<Key, Value>::rbegin() const
 {
-    Node<Key, Value> *curr = internalFind(key);
-    if (curr == NULL)
-        throw std::out_of_range("Invalid key");
-    return curr->getValue();
+    return reverse_iterator(end());
 }
 
+/**
+ * Returns the reverse iterator past the smallest item
+ */
 template <class Key, class Value>
-Value const &BinarySearchTree<Key, Value>::operator[](const Key &key) const
+typename BinarySearchTree<Key, Value>::reverse_iterator
+BinarySearchTree<Key, Value>::rend() const
 {
-    Node<Key, Value> *curr = internalFind(key);
-    if (curr == NULL)
-        throw std::out_of_range("Invalid key");
-    return curr->getValue();
+    return reverse_iterator(begin());
+}
+
+template <class Key, class Value>
+typename BinarySearchTree<Key, Value>::const_reverse_iterator
+BinarySearchTree<Key, Value>::crbegin() const
+{
+    return const_reverse_iterator(cend());
+}
+
+template <class Key, class Value>
+typename BinarySearchTree<Key, Value>::const_reverse_iterator
+BinarySearchTree<Key, Value>::crend() const
+{
+    return const_reverse_iterator(cbegin());
 }
 
 /**
- * An insert method to insert into a Binary Search Tree.
- * The tree will not remain balanced when inserting.
- * Recall: If key is already in the tree, you should
- * overwrite the current value with the updated value.
+ * Returns a stack_cursor at the smallest item, found with a descent from
+ * the root in O(log n) for a balanced tree
  */
 template <class Key, class Value>
-void BinarySearchTree<Key, Value>::insert(const std::pair<const Key, Value> &keyValuePair)
+typename BinarySearchTree<Key, Value>::stack_cursor
+BinarySearchTree<Key, Value>::begin_cursor() const
 {
-    // checking if insert is null 
-    if (root_ == nullptr)
-    {
-        // if it is, then we add new node 
-        root_ = new Node<Key, Value>(keyValuePair.first, keyValuePair.second, NULL);
-        return;
-    }
-    else
+    stack_cursor first(this);
+    first.descend(root_, true);
+    return first;
+}
+
+/**
+ * Returns the stack_cursor past the largest item
+ */
+template <class Key, class Value>
+typename BinarySearchTree<Key, Value>::stack_cursor
+BinarySearchTree<Key, Value>::end_cursor() const
+{
+    return stack_cursor(this);
+}
+
+/**
+ * Returns an iterator to the item with the given key, k
+ * or the end iterator if k does not exist in the tree
+ */
+template <class Key, class Value>
+typename BinarySearchTree<Key, Value>::iterator
+BinarySearchTree<Key, Value>::find(const Key &k) const
+{
+    Node<Key, Value> *curr = internalFind(k);
+    BinarySearchTree<Key, Value>::iterator it(curr, this);
+    return it;
+}
+
+/**
+ * Looks up count keys at once, storing an iterator for each in out (end()
+ * where the key is missing). Lookups advance in lockstep in groups of
+ * BATCH_GROUP: each round moves every unfinished lookup in the group down one
+ * level and prefetches the child it will read next, so the cache misses of
+ * the different descents overlap instead of being paid one after another.
+ */
+template <class Key, class Value>
+void BinarySearchTree<Key, Value>::find_batch(const Key *keys, size_t count, iterator *out) const
+{
+    const size_t BATCH_GROUP = 16;
+    Node<Key, Value> *cursor[BATCH_GROUP];
+
+    for (size_t base = 0; base < count; base += BATCH_GROUP)
     {
-        // creating temp node 
-        Node<Key, Value> *c = root_;
+        size_t group = std::min(BATCH_GROUP, count - base);
+        size_t active = 0;
+        for (size_t i = 0; i < group; ++i)
+        {
+            cursor[i] = root_;
+            out[base + i] = end();
+            if (root_ != NULL)
+            {
+                ++active;
+            }
+        }
 
-        // iterating through while true 
-        while (true)
+        while (active > 0)
         {
-            // checking if c key is greater 
-            if (keyValuePair.first < c->getKey())
+            for (size_t i = 0; i < group; ++i)
             {
-                // if c getLeft is null, then we add a new node 
-                if (c->getLeft() == NULL)
+                Node<Key, Value> *c = cursor[i];
+                if (c == NULL)
+                {
+                    continue;
+                }
+                const Key &k = keys[base + i];
+                pushOnDescent(c);
+                Node<Key, Value> *next;
+                if (k < c->getKey())
                 {
-                    Node<Key, Value> *ins2 = new Node<Key, Value>(keyValuePair.first, keyValuePair.second, c);
-                    c->setLeft(ins2);
-                    break;
+                    next = c->getLeft();
+                }
+                else if (c->getKey() < k)
+                {
+                    next = c->getRight();
                 }
-                // if not then we iterate to next left 
                 else
                 {
-                    c = c->getLeft();
+                    out[base + i] = iterator(c, this);
+                    next = NULL;
                 }
-            }
-            // checking if c key is less 
-            else if (keyValuePair.first > c->getKey())
-            {
-                // if c getRight is null, then we add a new node
-                if (c->getRight() == NULL)
+                if (next != NULL)
                 {
-                    Node<Key, Value> *ins = new Node<Key, Value>(keyValuePair.first, keyValuePair.second, c);
-                    c->setRight(ins);
-                    break;
+                    BST_PREFETCH(next);
                 }
-                // if not then we iterate to next left 
                 else
                 {
-                    c = c->getRight();
+                    --active;
                 }
+                cursor[i] = next;
+            }
+        }
+    }
+}
+
+/**
+ * Convenience overload of find_batch that resizes out to match keys.
+ */
+template <class Key, class Value>
+void BinarySearchTree<Key, Value>::find_batch(const std::vector<Key> &keys, std::vector<iterator> &out) const
+{
+    out.resize(keys.size());
+    if (!keys.empty())
+    {
+        find_batch(&keys[0], keys.size(), &out[0]);
+    }
+}
+
+/**
+ * Finger search: looks up key starting from the node hint points at rather
+ * than from the root. The search climbs only until it reaches a subtree whose
+ * key range contains key and descends from there, so it costs O(log d) in a
+ * balanced tree when key is d positions away from the hint. An end() hint
+ * searches from the root.
+ */
+template <class Key, class Value>
+typename BinarySearchTree<Key, Value>::iterator
+BinarySearchTree<Key, Value>::find_from(const iterator &hint, const Key &key) const
+{
+    Node<Key, Value> *c = fingerStart(hint.current_, key);
+    while (c != NULL)
+    {
+        pushOnDescent(c);
+        if (key < c->getKey())
+        {
+            c = c->getLeft();
+        }
+        else if (c->getKey() < key)
+        {
+            c = c->getRight();
+        }
+        else
+        {
+            break;
+        }
+    }
+    return iterator(c, this);
+}
+
+/**
+ * Returns an iterator to the first item whose key is not less than key, or
+ * end() if there is none.
+ */
+template <class Key, class Value>
+typename BinarySearchTree<Key, Value>::iterator BinarySearchTree<Key, Value>::lower_bound(const Key &key) const
+{
+    Node<Key, Value> *best = NULL;
+    Node<Key, Value> *c = root_;
+    while (c != NULL)
+    {
+        pushOnDescent(c);
+        if (c->getKey() < key)
+        {
+            c = c->getRight();
+        }
+        else
+        {
+            best = c;
+            c = c->getLeft();
+        }
+    }
+    return iterator(best, this);
+}
+
+/**
+ * Returns an iterator to the first item whose key is greater than key, or
+ * end() if there is none.
+ */
+template <class Key, class Value>
+typename BinarySearchTree<Key, Value>::iterator BinarySearchTree<Key, Value>::upper_bound(const Key &key) const
+{
+    Node<Key, Value> *best = NULL;
+    Node<Key, Value> *c = root_;
+    while (c != NULL)
+    {
+        pushOnDescent(c);
+        if (key < c->getKey())
+        {
+            best = c;
+            c = c->getLeft();
+        }
+        else
+        {
+            c = c->getRight();
+        }
+    }
+    return iterator(best, this);
+}
+
+/**
+ * Returns the range [lower_bound(key), upper_bound(key)) of items with the
+ * given key, which holds more than one item only in a Multimap.
+ */
+template <class Key, class Value>
+std::pair<typename BinarySearchTree<Key, Value>::iterator, typename BinarySearchTree<Key, Value>::iterator>
+BinarySearchTree<Key, Value>::equal_range(const Key &key) const
+{
+    return std::make_pair(lower_bound(key), upper_bound(key));
+}
+
+/**
+ * Returns the number of items with the given key, in O(log n + count).
+ */
+template <class Key, class Value>
+size_t BinarySearchTree<Key, Value>::count(const Key &key) const
+{
+    size_t n = 0;
+    for (iterator it = lower_bound(key); it != end() && !(key < it->first); ++it)
+    {
+        ++n;
+    }
+    return n;
+}
+
+/**
+ * Inserts like insert(), but finds the insertion point by a finger search
+ * from hint. Returns an iterator to the item, which makes a good hint for the
+ * next insert when keys arrive nearly in order.
+ */
+template <class Key, class Value>
+typename BinarySearchTree<Key, Value>::iterator
+BinarySearchTree<Key, Value>::insert_near(const iterator &hint, const std::pair<const Key, Value> &keyValuePair)
+{
+    Node<Key, Value> *parent = NULL;
+    Node<Key, Value> *c = fingerStart(hint.current_, keyValuePair.first);
+    while (c != NULL)
+    {
+        pushOnDescent(c);
+        parent = c;
+        if (keyValuePair.first < c->getKey())
+        {
+            c = c->getLeft();
+        }
+        else if (c->getKey() < keyValuePair.first)
+        {
+            c = c->getRight();
+        }
+        else
+        {
+            c->setValue(keyValuePair.second);
+            valueChanged(c);
+            return iterator(c, this);
+        }
+    }
+    return iterator(attachLeaf(parent, keyValuePair), this);
+}
+
+/**
+ * Updates or inserts in a single descent: if key is present, calls
+ * fnIfPresent(value) on its value in place; otherwise inserts key with the
+ * value returned by makeIfAbsent(). Rebalancing only happens when a node is
+ * actually created. Returns an iterator to the item.
+ *
+ * E.g. counting: tree.upsert(k, [](int &v) { ++v; }, []() { return 1; });
+ */
+template <class Key, class Value>
+template <typename Update, typename Make>
+typename BinarySearchTree<Key, Value>::iterator
+BinarySearchTree<Key, Value>::upsert(const Key &key, Update fnIfPresent, Make makeIfAbsent)
+{
+    Node<Key, Value> *parent = NULL;
+    Node<Key, Value> *c = root_;
+    while (c != NULL)
+    {
+        pushOnDescent(c);
+        parent = c;
+        if (key < c->getKey())
+        {
+            c = c->getLeft();
+        }
+        else if (c->getKey() < key)
+        {
+            c = c->getRight();
+        }
+        else
+        {
+            fnIfPresent(c->getValue());
+            valueChanged(c);
+            return iterator(c, this);
+        }
+    }
+    return iterator(attachLeaf(parent, std::pair<const Key, Value>(key, makeIfAbsent())), this);
+}
+
+/**
+ * Calls fn(value) on the value stored under key, in place, and returns true;
+ * returns false (without calling fn) if key is not in the tree.
+ */
+template <class Key, class Value>
+template <typename Update>
+bool BinarySearchTree<Key, Value>::modify(const Key &key, Update fn)
+{
+    Node<Key, Value> *c = internalFind(key);
+    if (c == NULL)
+    {
+        return false;
+    }
+    fn(c->getValue());
+    valueChanged(c);
+    return true;
+}
+
+/**
+ * @precondition The key exists in the map
+ * Returns the value associated with the key
+ */
+template <class Key, class Value>
+Value &BinarySearchTree<Key, Value>::operator[](const Key &key)
+{
+    Node<Key, Value> *curr = internalFind(key);
+    if (curr == NULL)
+        throw std::out_of_range("Invalid key");
+    return curr->getValue();
+}
+
+template <class Key, class Value>
+Value const &BinarySearchTree<Key, Value>::operator[](const Key &key) const
+{
+    Node<Key, Value> *curr = internalFind(key);
+    if (curr == NULL)
+        throw std::out_of_range("Invalid key");
+    return curr->getValue();
+}
+
+/**
+ * An insert method to insert into a Binary Search Tree.
+ * The tree will not remain balanced when inserting.
+ * Recall: If key is already in the tree, you should
+ * overwrite the current value with the updated value.
+ */
+template <class Key, class Value>
+void BinarySearchTree<Key, Value>::insert(const std::pair<const Key, Value> &keyValuePair)
+{
+    Node<Key, Value> *parent = NULL;
+    Node<Key, Value> *c = root_;
+
+    // walking down to the insertion point
+    while (c != NULL)
+    {
+        pushOnDescent(c);
+        parent = c;
+        if (keyValuePair.first < c->getKey())
+        {
+            c = c->getLeft();
+        }
+        else if (keyValuePair.first > c->getKey())
+        {
+            c = c->getRight();
+        }
+        else // both of them are the same
+        {
+            c->setValue(keyValuePair.second);
+            valueChanged(c);
+            return;
+        }
+    }
+    attachLeaf(parent, keyValuePair);
+}
+/**
+ * A remove method to remove a specific key from a Binary Search Tree.
+ * Recall: The writeup specifies that if a node has 2 children you
+ * should swap with the predecessor and then remove.
+ */
+template <typename Key, typename Value>
+void BinarySearchTree<Key, Value>::remove(const Key &key)
+{
+    // root check
+    if (root_ == NULL) {
+        return; 
+    }
+
+    // finding the key 
+    Node<Key, Value> *c = this->internalFind(key); 
+
+    // if c is null then we return 
+    if (c == NULL) {
+        return; 
+    }
+    removeNode(c);
+}
+
+/**
+ * Removes the smallest item, if any, without a key search. With remove(),
+ * begin() and insert() this makes the tree a priority queue.
+ */
+template <typename Key, typename Value>
+void BinarySearchTree<Key, Value>::pop_min()
+{
+    if (leftmost_ != NULL)
+    {
+        removeNode(leftmost_);
+    }
+}
+
+/**
+ * Removes the largest item, if any, without a key search.
+ */
+template <typename Key, typename Value>
+void BinarySearchTree<Key, Value>::pop_max()
+{
+    if (rightmost_ != NULL)
+    {
+        removeNode(rightmost_);
+    }
+}
+
+/**
+ * Unlinks and frees c, which must be in this tree. Every tree removes
+ * through here, so balanced trees override this to rebalance afterwards.
+ */
+template <typename Key, typename Value>
+void BinarySearchTree<Key, Value>::removeNode(Node<Key, Value> *c)
+{
+    // case for when there are 2 children 
+    // having this first bc after swap we will either be in a 0-child or 1-child case
+    if(c->getLeft() != NULL && c->getRight() != NULL) {
+        nodeSwap(c,predecessor(c)); 
+    }
+
+    // case for when there is one child and 0 children  
+    // creating temp node to store it 
+    Node <Key, Value> * one; 
+    // 0 children 
+    if (c->getRight() == NULL && c->getLeft() == NULL) {
+        one = NULL; 
+    }
+
+    // one child 
+    if (c->getRight()==NULL && c->getLeft()!=NULL) {
+        one = c->getLeft(); 
+    } else if(c->getRight()!=NULL && c->getLeft()==NULL){
+        one = c->getRight();
+    } 
+
+    // updating the parent node to complete the promote functionality  
+    noteUnlinking(c);
+    Node <Key, Value> * two = c -> getParent(); 
+    if (two == NULL) {
+        root_ = one; 
+    } else {
+        if (c->getParent()->getLeft() == c) {
+            two->setLeft(one); 
+        } else if (c->getParent()->getRight() == c) {
+            two->setRight(one); 
+        } 
+    }
+
+    // check to set the parent of one to two 
+    if (one != NULL) {
+        one->setParent(two); 
+    }
+    // deleting c 
+    destroyNode(c); 
+}
+
+// predecessor
+template <class Key, class Value>
+Node<Key, Value> *
+BinarySearchTree<Key, Value>::predecessor(Node<Key, Value> *current)
+{
+    // checking if left exists
+    if (current->getLeft() != NULL)
+    {
+        // if it does then we go all the way to the right 
+        Node<Key, Value> *cur = current->getLeft();
+        while (cur->getRight() != NULL)
+        {
+            cur = cur->getRight();
+        }
+        return cur;
+    }
+
+    // if not, then we walk up the chain and find the first node
+    // who is a right child of his parent 
+    Node<Key, Value> *cur = current;
+    while (cur->getParent() != nullptr){
+      if (cur->getParent()->getRight() == cur){
+        return cur->getParent();
+      }
+      else{
+        cur = cur->getParent();
+      }
+    }
+    return nullptr;
+
+}
+
+
+// successor
+template <class Key, class Value>
+Node<Key, Value> *
+BinarySearchTree<Key, Value>::successor(Node<Key, Value> *current)
+{
+    // check if right child exists
+    if (current->getRight() != NULL)
+    {
+        // if it does, we go all the way to the left 
+        Node<Key, Value> *cur = current->getRight();
+        while (cur->getLeft() != NULL)
+        {
+            cur = cur->getLeft();
+        }
+        return cur;
+    }
+
+    // if not, then we walk up the chain and find the first node 
+    // who is a left child of his parent
+		Node<Key, Value> *cur = current;
+    while (cur->getParent() != nullptr){
+      if (cur->getParent()->getLeft() == cur){
+        return cur->getParent();
+      }
+      else{
+        cur = cur->getParent();
+      }
+    }
+    return nullptr; 
+}
+
+/**
+ * A method to remove all contents of the tree and
+ * reset the values in the tree for use again.
+ */
+template <typename Key, typename Value>
+void BinarySearchTree<Key, Value>::clear()
+{
+    deleteNode(root_); 
+    root_ = nullptr;
+    leftmost_ = nullptr;
+    rightmost_ = nullptr;
+}
+
+// helper function for delete
+template <typename Key, typename Value>
+void BinarySearchTree<Key, Value>::deleteNode(Node<Key, Value> *c)
+{
+    // deleting everything by using post order recursion
+    if (c == NULL)
+    {
+        return;
+    }
+    deleteNode(c->getLeft());
+    deleteNode(c->getRight());
+    destroyNode(c);
+}
+
+/**
+ * Frees a node that has already been unlinked from the tree. Trees that
+ * place nodes in storage of their own override this.
+ */
+template <typename Key, typename Value>
+void BinarySearchTree<Key, Value>::destroyNode(Node<Key, Value> *n)
+{
+    n->~Node<Key, Value>();
+    --usage_.liveNodes;
+    releaseBytes(n, usage_.nodeBytes, nodeAlign_);
+}
+
+/**
+ * Allocates a node of the tree's node type from the tree's resource and
+ * constructs it. All nodes of one tree have the same type, so its size is
+ * recorded here for memory_usage() and destroyNode().
+ */
+template <typename Key, typename Value>
+template <typename NodeType>
+NodeType *BinarySearchTree<Key, Value>::createNode(const Key &key, const Value &value, NodeType *parent)
+{
+    void *p = allocateBytes(sizeof(NodeType), alignof(NodeType));
+    NodeType *n;
+    try
+    {
+        n = new (p) NodeType(key, value, parent);
+    }
+    catch (...)
+    {
+        releaseBytes(p, sizeof(NodeType), alignof(NodeType));
+        throw;
+    }
+    usage_.nodeBytes = sizeof(NodeType);
+    nodeAlign_ = alignof(NodeType);
+    ++usage_.liveNodes;
+    return n;
+}
+
+/**
+ * Gets raw memory from the tree's resource and accounts for it.
+ */
+template <typename Key, typename Value>
+void *BinarySearchTree<Key, Value>::allocateBytes(size_t bytes, size_t align)
+{
+    void *p = resource_->allocate(bytes, align);
+    usage_.bytesInUse += bytes;
+    ++usage_.allocations;
+    return p;
+}
+
+/**
+ * Gives memory obtained from allocateBytes back to the tree's resource.
+ */
+template <typename Key, typename Value>
+void BinarySearchTree<Key, Value>::releaseBytes(void *p, size_t bytes, size_t align)
+{
+    resource_->deallocate(p, bytes, align);
+    usage_.bytesInUse -= bytes;
+    ++usage_.deallocations;
+}
+
+/**
+ * Called after the value stored in n was overwritten or updated in place by
+ * the tree's own update functions. Trees that derive data from values
+ * override this; the plain tree has nothing to do.
+ */
+template <typename Key, typename Value>
+void BinarySearchTree<Key, Value>::valueChanged(Node<Key, Value> *n)
+{
+    (void)n;
+}
+
+/**
+ * Profiles the subtree at top in one iterative post-order walk, taking each
+ * node's balance from the real heights of its subtrees (so it is the same
+ * for every kind of tree, whatever it stores).
+ */
+template <typename Key, typename Value>
+TreeProfile BinarySearchTree<Key, Value>::profileFrom(Node<Key, Value> *top)
+{
+    struct Step
+    {
+        Node<Key, Value> *node;
+        size_t depth;
+        bool entered;
+    };
+    TreeProfile result;
+    std::vector<Step> stack;
+    std::vector<int> heights;
+    if (top != NULL)
+    {
+        Step first = {top, 0, false};
+        stack.push_back(first);
+    }
+    while (!stack.empty())
+    {
+        Step &s = stack.back();
+        Node<Key, Value> *l = s.node->getLeft();
+        Node<Key, Value> *r = s.node->getRight();
+        if (!s.entered)
+        {
+            s.entered = true;
+            Step right = {r, s.depth + 1, false};
+            Step left = {l, s.depth + 1, false};
+            if (r != NULL)
+            {
+                stack.push_back(right);
+            }
+            if (l != NULL)
+            {
+                stack.push_back(left);
+            }
+            continue;
+        }
+        int rh = 0;
+        int lh = 0;
+        if (r != NULL)
+        {
+            rh = heights.back();
+            heights.pop_back();
+        }
+        if (l != NULL)
+        {
+            lh = heights.back();
+            heights.pop_back();
+        }
+        result.addNode(s.depth, rh - lh, l == NULL && r == NULL);
+        heights.push_back(1 + std::max(lh, rh));
+        stack.pop_back();
+    }
+    result.finish();
+    return result;
+}
+
+/**
+ * Returns true if every key is stored at most once, which is what the
+ * invariant checks expect; trees holding duplicate keys override this.
+ */
+template <typename Key, typename Value>
+bool BinarySearchTree<Key, Value>::keysUnique() const
+{
+    return true;
+}
+
+/**
+ * Whether rotations that know nothing of the tree's balancing (rebalance()
+ * and the auto-rebalance policy) may relink its nodes. Trees whose nodes
+ * store balances, colors or ranks return false, since those would go stale.
+ */
+template <typename Key, typename Value>
+bool BinarySearchTree<Key, Value>::relinkable() const
+{
+    return true;
+}
+
+/**
+ * Wraps a node in an iterator, for subclasses (which cannot use the
+ * iterator's protected constructor directly).
+ */
+template <typename Key, typename Value>
+typename BinarySearchTree<Key, Value>::iterator BinarySearchTree<Key, Value>::iteratorAt(Node<Key, Value> *n) const
+{
+    return iterator(n, this);
+}
+
+/**
+ * Returns the node an iterator points at (NULL for end()), for subclasses.
+ */
+template <typename Key, typename Value>
+Node<Key, Value> *BinarySearchTree<Key, Value>::nodeAt(const iterator &it)
+{
+    return it.current_;
+}
+
+/**
+ * Returns the node a search for key should descend from when starting at
+ * hint: the lowest ancestor of hint (or hint itself) whose subtree covers
+ * key. Climbing stops at the first ancestor on the far side of key, because
+ * everything below the child we came from lies between the two.
+ */
+template <typename Key, typename Value>
+Node<Key, Value> *BinarySearchTree<Key, Value>::fingerStart(Node<Key, Value> *hint, const Key &key) const
+{
+    // the climb may cross pending updates, so those trees search from the root
+    if (hint == NULL || pushesPending_)
+    {
+        return root_;
+    }
+    Node<Key, Value> *c = hint;
+    if (key < c->getKey())
+    {
+        while (c->getParent() != NULL)
+        {
+            Node<Key, Value> *p = c->getParent();
+            if (p->getRight() == c && p->getKey() < key)
+            {
+                break;
             }
-            else // both of them are the same 
+            c = p;
+        }
+    }
+    else if (c->getKey() < key)
+    {
+        while (c->getParent() != NULL)
+        {
+            Node<Key, Value> *p = c->getParent();
+            if (p->getLeft() == c && key < p->getKey())
             {
-                c->setValue(keyValuePair.second);
                 break;
             }
+            c = p;
         }
     }
+    return c;
+}
+
+/**
+ * Creates a node for keyValuePair and links it in as a child of parent (or as
+ * the root when parent is NULL), on the side its key belongs. The key must
+ * not already be in the tree and parent must have a free slot on that side.
+ * Balanced trees override this to rebalance after the link. Returns the new node.
+ */
+template <typename Key, typename Value>
+Node<Key, Value> *BinarySearchTree<Key, Value>::attachLeaf(Node<Key, Value> *parent,
+                                                           const std::pair<const Key, Value> &keyValuePair)
+{
+    Node<Key, Value> *n = createNode(keyValuePair.first, keyValuePair.second, parent);
+    if (parent == NULL)
+    {
+        root_ = n;
+    }
+    else if (keyValuePair.first < parent->getKey())
+    {
+        parent->setLeft(n);
+    }
+    else
+    {
+        parent->setRight(n);
+    }
+    noteLinked(n);
+    if (autoRebalance_ > 0)
+    {
+        rebalanceIfDeep(n, autoRebalance_ * std::log2((double)usage_.liveNodes), std::pow(2.0, -1.0 / autoRebalance_));
+    }
+    return n;
+}
+
+/**
+ * Updates the cached first and last nodes for n, a leaf just linked into
+ * the tree (before any rebalancing, which keeps the key order anyway). A new
+ * leaf is a new extreme exactly when it hangs off the old one on the outer
+ * side.
+ */
+template <typename Key, typename Value>
+void BinarySearchTree<Key, Value>::noteLinked(Node<Key, Value> *n)
+{
+    Node<Key, Value> *p = n->getParent();
+    if (p == NULL)
+    {
+        leftmost_ = n;
+        rightmost_ = n;
+    }
+    else if (p == leftmost_ && p->getLeft() == n)
+    {
+        leftmost_ = n;
+    }
+    else if (p == rightmost_ && p->getRight() == n)
+    {
+        rightmost_ = n;
+    }
+}
+
+/**
+ * Updates the cached first and last nodes for n, a node with at most one
+ * child that is about to be spliced out while its links are still intact.
+ * The smallest node has no left child, so its successor is found in O(1)
+ * in a balanced tree, and likewise for the largest.
+ */
+template <typename Key, typename Value>
+void BinarySearchTree<Key, Value>::noteUnlinking(Node<Key, Value> *n)
+{
+    if (n == leftmost_)
+    {
+        leftmost_ = successor(n);
+    }
+    if (n == rightmost_)
+    {
+        rightmost_ = predecessor(n);
+    }
 }
+
 /**
- * A remove method to remove a specific key from a Binary Search Tree.
- * Recall: The writeup specifies that if a node has 2 children you
- * should swap with the predecessor and then remove.
+ * Recomputes the cached first and last nodes by walking both spines, for
+ * updates that replace nodes wholesale (e.g. AVLTree::compact()).
  */
 template <typename Key, typename Value>
-void BinarySearchTree<Key, Value>::remove(const Key &key)
+void BinarySearchTree<Key, Value>::findExtremes()
 {
-    // root check
-    if (root_ == NULL) {
-        return; 
-    }
-
-    // finding the key 
-    Node<Key, Value> *c = this->internalFind(key); 
-
-    // if c is null then we return 
-    if (c == NULL) {
-        return; 
+    leftmost_ = root_;
+    rightmost_ = root_;
+    if (root_ == NULL)
+    {
+        return;
     }
-
-    // case for when there are 2 children 
-    // having this first bc after swap we will either be in a 0-child or 1-child case
-    if(c->getLeft() != NULL && c->getRight() != NULL) {
-        nodeSwap(c,predecessor(c)); 
+    while (leftmost_->getLeft() != NULL)
+    {
+        leftmost_ = leftmost_->getLeft();
     }
-
-    // case for when there is one child and 0 children  
-    // creating temp node to store it 
-    Node <Key, Value> * one; 
-    // 0 children 
-    if (c->getRight() == NULL && c->getLeft() == NULL) {
-        one = NULL; 
+    while (rightmost_->getRight() != NULL)
+    {
+        rightmost_ = rightmost_->getRight();
     }
+}
 
-    // one child 
-    if (c->getRight()==NULL && c->getLeft()!=NULL) {
-        one = c->getLeft(); 
-    } else if(c->getRight()!=NULL && c->getLeft()==NULL){
-        one = c->getRight();
-    } 
-
-    // updating the parent node to complete the promote functionality  
-    Node <Key, Value> * two = c -> getParent(); 
-    if (two == NULL) {
-        root_ = one; 
-    } else {
-        if (c->getParent()->getLeft() == c) {
-            two->setLeft(one); 
-        } else if (c->getParent()->getRight() == c) {
-            two->setRight(one); 
-        } 
+/**
+ * A helper function to find the smallest node in the tree (NULL if it is
+ * empty), which is cached. With pending updates it descends from the root
+ * instead, pushing them out of the way.
+ */
+template <typename Key, typename Value>
+Node<Key, Value> *
+BinarySearchTree<Key, Value>::getSmallestNode() const
+{
+    if (!pushesPending_ || root_ == NULL)
+    {
+        return leftmost_;
     }
-
-    // check to set the parent of one to two 
-    if (one != NULL) {
-        one->setParent(two); 
+    Node<Key, Value> *c = root_;
+    for (pushPending(c); c->getLeft() != NULL; pushPending(c))
+    {
+        c = c->getLeft();
     }
-    // deleting c 
-    delete c; 
+    return c;
 }
 
-// predecessor
-template <class Key, class Value>
+/**
+ * The mirror image of getSmallestNode().
+ */
+template <typename Key, typename Value>
 Node<Key, Value> *
-BinarySearchTree<Key, Value>::predecessor(Node<Key, Value> *current)
+BinarySearchTree<Key, Value>::getLargestNode() const
 {
-    // checking if left exists
-    if (current->getLeft() != NULL)
+    if (!pushesPending_ || root_ == NULL)
     {
-        // if it does then we go all the way to the right 
-        Node<Key, Value> *cur = current->getLeft();
-        while (cur->getRight() != NULL)
-        {
-            cur = cur->getRight();
-        }
-        return cur;
+        return rightmost_;
     }
-
-    // if not, then we walk up the chain and find the first node
-    // who is a right child of his parent 
-    Node<Key, Value> *cur = current;
-    while (cur->getParent() != nullptr){
-      if (cur->getParent()->getRight() == cur){
-        return cur->getParent();
-      }
-      else{
-        cur = cur->getParent();
-      }
+    Node<Key, Value> *c = root_;
+    for (pushPending(c); c->getRight() != NULL; pushPending(c))
+    {
+        c = c->getRight();
     }
-    return nullptr;
-
+    return c;
 }
 
+/**
+ * Hands whatever update n holds for its children down to them. Trees that
+ * keep range updates in their nodes (see LazyAVLTree) override this and set
+ * pushesPending_; the base tree holds nothing back.
+ */
+template <typename Key, typename Value>
+void BinarySearchTree<Key, Value>::pushPending(Node<Key, Value> *n) const
+{
+    (void)n;
+}
 
-// successor
-template <class Key, class Value>
-Node<Key, Value> *
-BinarySearchTree<Key, Value>::successor(Node<Key, Value> *current)
+/**
+ * Called on each node a search is about to read below, so that its children
+ * hold current values. Costs a single test in trees without pending updates.
+ */
+template <typename Key, typename Value>
+void BinarySearchTree<Key, Value>::pushOnDescent(Node<Key, Value> *n) const
 {
-    // check if right child exists
-    if (current->getRight() != NULL)
+    if (pushesPending_)
     {
-        // if it does, we go all the way to the left 
-        Node<Key, Value> *cur = current->getRight();
-        while (cur->getLeft() != NULL)
-        {
-            cur = cur->getLeft();
-        }
-        return cur;
-    }
-
-    // if not, then we walk up the chain and find the first node 
-    // who is a left child of his parent
-		Node<Key, Value> *cur = current;
-    while (cur->getParent() != nullptr){
-      if (cur->getParent()->getLeft() == cur){
-        return cur->getParent();
-      }
-      else{
-        cur = cur->getParent();
-      }
+        pushPending(n);
     }
-    return nullptr; 
 }
 
 /**
- * A method to remove all contents of the tree and
- * reset the values in the tree for use again.
+ * Pushes every pending update in the subtree at top down to maxDepth levels,
+ * before a walk that reads all of it.
  */
 template <typename Key, typename Value>
-void BinarySearchTree<Key, Value>::clear()
+void BinarySearchTree<Key, Value>::pushSubtree(Node<Key, Value> *top, size_t maxDepth) const
 {
-    deleteNode(root_); 
-    root_ = nullptr;
+    if (pushesPending_)
+    {
+        walkPreorder(top, maxDepth, [this](Node<Key, Value> *n, size_t) { pushPending(n); });
+    }
 }
 
-// helper function for delete
+/**
+ * The in-order successor of n for an iterator step. The nodes passed on the
+ * way down into a right subtree are pushed first; the ancestors of n were
+ * pushed when n was reached, so climbing needs nothing.
+ */
 template <typename Key, typename Value>
-void BinarySearchTree<Key, Value>::deleteNode(Node<Key, Value> *c)
+Node<Key, Value> *BinarySearchTree<Key, Value>::nextNode(Node<Key, Value> *n) const
 {
-    // deleting everything by using post order recursion
-    if (c == NULL)
+    if (!pushesPending_ || n->getRight() == NULL)
     {
-        return;
+        return successor(n);
     }
-    deleteNode(c->getLeft());
-    deleteNode(c->getRight());
-    delete c;
+    pushPending(n);
+    Node<Key, Value> *c = n->getRight();
+    for (pushPending(c); c->getLeft() != NULL; pushPending(c))
+    {
+        c = c->getLeft();
+    }
+    return c;
 }
 
 /**
- * A helper function to find the smallest node in the tree.
+ * The in-order predecessor of n for an iterator step, or the largest node
+ * for n NULL (a step back from end()); the mirror image of nextNode().
  */
 template <typename Key, typename Value>
-Node<Key, Value> *
-BinarySearchTree<Key, Value>::getSmallestNode() const
+Node<Key, Value> *BinarySearchTree<Key, Value>::prevNode(Node<Key, Value> *n) const
 {
-    // iterating all the way to the left
-    Node<Key, Value> *c = root_;
-    while (c ->getLeft() != NULL)
+    if (n == NULL)
+    {
+        return getLargestNode();
+    }
+    if (!pushesPending_ || n->getLeft() == NULL)
+    {
+        return predecessor(n);
+    }
+    pushPending(n);
+    Node<Key, Value> *c = n->getLeft();
+    for (pushPending(c); c->getRight() != NULL; pushPending(c))
     {
-		c = c->getLeft();
+        c = c->getRight();
     }
     return c;
 }
@@ -683,6 +1959,7 @@ Node<Key, Value> *BinarySearchTree<Key, Value>::internalFind(const Key &key) con
         // iterating through the tree to find the node 
         Node<Key, Value> *c = root_;
         while (c != NULL) {
+        pushOnDescent(c);
         if (c->getKey() == key)
         {
             return c;
@@ -764,6 +2041,216 @@ bool BinarySearchTree<Key, Value>::isBalanced() const
     return (l != (-1+zero) && r != -1);
 }
 
+/**
+ * Relinks the whole tree into a complete binary tree (every level full but
+ * possibly the last) with the Day-Stout-Warren algorithm: O(n) rotations
+ * and O(1) extra memory. Iterators stay valid, since no node is moved or
+ * freed. Throws std::logic_error on trees whose nodes keep balance data of
+ * their own (see relinkable()), even when called through a base reference.
+ */
+template <typename Key, typename Value>
+void BinarySearchTree<Key, Value>::rebalance()
+{
+    if (!relinkable())
+    {
+        throw std::logic_error("this tree keeps itself balanced and cannot be relinked by rebalance()");
+    }
+    if (root_ != NULL)
+    {
+        rebalanceSubtree(root_);
+    }
+}
+
+/**
+ * With c > 1, every insert that lands more than c * log2(n) levels deep
+ * rebuilds, with the same in-place algorithm as rebalance(), the subtree of
+ * the lowest ancestor heavier on the new node's side than 2^(-1/c) of its
+ * size. Such an ancestor always exists (as in a scapegoat tree), so depths
+ * stay within c * log2(n) + 1 for inserts at O(log n) amortized cost, where
+ * rebuilding the whole tree each time would cost O(n) per sorted insert.
+ * c = 0 turns the policy off again. Throws std::logic_error, like
+ * rebalance(), on trees that are not relinkable().
+ */
+template <typename Key, typename Value>
+void BinarySearchTree<Key, Value>::setAutoRebalance(double c)
+{
+    if (!relinkable())
+    {
+        throw std::logic_error("this tree keeps itself balanced and cannot be relinked by rebalance()");
+    }
+    if (c != 0 && !(c > 1))
+    {
+        throw std::invalid_argument("auto-rebalance factor must be above 1");
+    }
+    autoRebalance_ = c;
+}
+
+/**
+ * DSW on the subtree at r, which stays attached in the same place: first
+ * right rotations turn it into a right-leaning vine, then rounds of left
+ * rotations at every other vine node fold the vine into a complete tree.
+ */
+template <typename Key, typename Value>
+void BinarySearchTree<Key, Value>::rebalanceSubtree(Node<Key, Value> *r)
+{
+    Node<Key, Value> *parent = r->getParent();
+    bool wasLeft = (parent != NULL && parent->getLeft() == r);
+
+    // vine: rotate each left child up until the spine has no left children
+    size_t size = 0;
+    Node<Key, Value> *c = r;
+    while (c != NULL)
+    {
+        if (c->getLeft() != NULL)
+        {
+            Node<Key, Value> *l = c->getLeft();
+            rotateRightAt(c);
+            c = l;
+        }
+        else
+        {
+            ++size;
+            c = c->getRight();
+        }
+    }
+
+    // each round left-rotates at every other node down the vine; the first
+    // only folds the nodes beyond the largest full tree, so that the bottom
+    // level ends up filled from the left
+    size_t full = 1;
+    while (full * 2 + 1 <= size)
+    {
+        full = full * 2 + 1;
+    }
+    size_t rotations = size - full;
+    while (true)
+    {
+        c = (parent == NULL) ? root_ : (wasLeft ? parent->getLeft() : parent->getRight());
+        for (size_t i = 0; i < rotations; ++i)
+        {
+            Node<Key, Value> *up = c->getRight();
+            rotateLeftAt(c);
+            c = up->getRight();
+        }
+        if (full <= 1)
+        {
+            break;
+        }
+        full /= 2;
+        rotations = full;
+    }
+}
+
+/**
+ * Checks the depth of the node just linked and, if it is deeper than limit,
+ * rebuilds the subtree of its scapegoat: the lowest ancestor with a child
+ * heavier than alpha times its own size. Returns whether it rebuilt. Used by
+ * the auto-rebalance policy (see setAutoRebalance()) and by ScapegoatTree.
+ */
+template <typename Key, typename Value>
+bool BinarySearchTree<Key, Value>::rebalanceIfDeep(Node<Key, Value> *n, double limit, double alpha)
+{
+    // the depth is found by climbing, so finger inserts need not track it
+    size_t depth = 0;
+    for (Node<Key, Value> *a = n->getParent(); a != NULL && depth <= limit; a = a->getParent())
+    {
+        ++depth;
+    }
+    if (depth <= limit)
+    {
+        return false;
+    }
+
+    // climb, keeping the size of the subtree we came from, until an
+    // ancestor has a child heavier than alpha times its own size
+    Node<Key, Value> *child = n;
+    size_t childSize = 1;
+    for (Node<Key, Value> *a = n->getParent(); a != NULL; a = a->getParent())
+    {
+        Node<Key, Value> *sibling = (a->getLeft() == child) ? a->getRight() : a->getLeft();
+        size_t aSize = childSize + 1 + countNodes(sibling);
+        if ((double)childSize > alpha * (double)aSize)
+        {
+            rebalanceSubtree(a);
+            return true;
+        }
+        child = a;
+        childSize = aSize;
+    }
+    return false;
+}
+
+/**
+ * Rotates x's right child up into x's place; x becomes its left child.
+ */
+template <typename Key, typename Value>
+void BinarySearchTree<Key, Value>::rotateLeftAt(Node<Key, Value> *x)
+{
+    Node<Key, Value> *y = x->getRight();
+    Node<Key, Value> *p = x->getParent();
+    x->setRight(y->getLeft());
+    if (y->getLeft() != NULL)
+    {
+        y->getLeft()->setParent(x);
+    }
+    y->setParent(p);
+    if (p == NULL)
+    {
+        root_ = y;
+    }
+    else if (p->getLeft() == x)
+    {
+        p->setLeft(y);
+    }
+    else
+    {
+        p->setRight(y);
+    }
+    y->setLeft(x);
+    x->setParent(y);
+}
+
+/**
+ * Rotates x's left child up into x's place; x becomes its right child.
+ */
+template <typename Key, typename Value>
+void BinarySearchTree<Key, Value>::rotateRightAt(Node<Key, Value> *x)
+{
+    Node<Key, Value> *y = x->getLeft();
+    Node<Key, Value> *p = x->getParent();
+    x->setLeft(y->getRight());
+    if (y->getRight() != NULL)
+    {
+        y->getRight()->setParent(x);
+    }
+    y->setParent(p);
+    if (p == NULL)
+    {
+        root_ = y;
+    }
+    else if (p->getLeft() == x)
+    {
+        p->setLeft(y);
+    }
+    else
+    {
+        p->setRight(y);
+    }
+    y->setRight(x);
+    x->setParent(y);
+}
+
+/**
+ * Counts the nodes of the subtree at r in O(1) memory.
+ */
+template <typename Key, typename Value>
+size_t BinarySearchTree<Key, Value>::countNodes(Node<Key, Value> *r)
+{
+    size_t count = 0;
+    walkPreorder(r, (size_t)-1, [&count](Node<Key, Value> *, size_t) { ++count; });
+    return count;
+}
+
 template <typename Key, typename Value>
 void BinarySearchTree<Key, Value>::nodeSwap(Node<Key, Value> *n1, Node<Key, Value> *n2)
 {
@@ -874,6 +2361,9 @@ void BinarySearchTree<Key, Value>::nodeSwap(Node<Key, Value> *n1, Node<Key, Valu
 // include print function (in its own file because it's fairly long)
 #include "print_bst.h"
 
+// include the streaming DOT and JSON exporters (likewise)
+#include "export_bst.h"
+
 /*
 ---------------------------------------------------
 End implementations for the BinarySearchTree class.
@@ -0,0 +1,262 @@
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "equal-paths.h"
+#include "equal-paths-parallel.h"
+#include "latency_histogram.h"
+
+using namespace std;
+
+/**
+ * Benchmark driver for equalPaths. Times the original recursive check, the
+ * iterative equalPaths and equalPathsParallel on trees of n nodes:
+ *   balanced - a perfect tree, all leaves on one level (a full traversal)
+ *   late     - a perfect tree with one extra leaf in the middle, so a walk
+ *              in either direction checks half the leaves before failing
+ *   random   - a BST built from random keys (mismatches appear early)
+ *   skewed   - a chain of left children, as deep as the tree is large
+ *
+ * Usage:
+ *   equal-paths-bench [-n N] [-threads T] [-seed S]
+ */
+
+static unsigned long long rngState = 88172645463325252ULL;
+
+static unsigned long long nextRandom()
+{
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return rngState;
+}
+
+// Deeper trees than this are not given to the recursive check, which would
+// overflow the call stack.
+static const int MAX_RECURSION_DEPTH = 100000;
+
+/**
+ * A tree whose nodes live in one vector, with the height of its deepest leaf.
+ */
+struct Shape
+{
+    string name;
+    vector<Node> nodes;
+    int height;
+
+    Node *root() { return nodes.empty() ? nullptr : &nodes[0]; }
+};
+
+/**
+ * The recursive check equalPaths used to make, kept as the baseline.
+ */
+static bool recursiveCheck(int lev, Node *root, int *leaf)
+{
+    if (root == nullptr)
+    {
+        return true;
+    }
+    if (root->right == nullptr && root->left == nullptr)
+    {
+        if (*leaf == 0)
+        {
+            *leaf = lev;
+            return true;
+        }
+        return lev == *leaf;
+    }
+    return recursiveCheck(lev + 1, root->right, leaf) && recursiveCheck(lev + 1, root->left, leaf);
+}
+
+static bool recursiveEqualPaths(Node *root)
+{
+    int leafLevel = 0;
+    return recursiveCheck(0, root, &leafLevel);
+}
+
+/**
+ * Builds a perfect tree with the largest 2^k - 1 nodes that fits in n, in
+ * heap order; with extraLeaf, the leftmost leaf of the root's right subtree
+ * gets one more child.
+ */
+static void buildPerfect(Shape &s, int n, bool extraLeaf)
+{
+    int count = 1;
+    s.height = 0;
+    while (2 * count + 1 <= n)
+    {
+        count = 2 * count + 1;
+        ++s.height;
+    }
+    s.nodes.reserve(count + 1);
+    for (int i = 0; i < count; ++i)
+    {
+        s.nodes.push_back(Node(i));
+    }
+    for (int i = 0; 2 * i + 2 < count; ++i)
+    {
+        s.nodes[i].left = &s.nodes[2 * i + 1];
+        s.nodes[i].right = &s.nodes[2 * i + 2];
+    }
+    if (extraLeaf)
+    {
+        s.nodes.push_back(Node(count));
+        int middle = (count > 1) ? 2 : 0;
+        while (s.nodes[middle].left != nullptr)
+        {
+            middle = 2 * middle + 1;
+        }
+        s.nodes[middle].left = &s.nodes[count];
+        ++s.height;
+    }
+}
+
+/**
+ * Builds a BST by inserting n random keys.
+ */
+static void buildRandom(Shape &s, int n)
+{
+    s.nodes.reserve(n);
+    s.height = 0;
+    for (int i = 0; i < n; ++i)
+    {
+        s.nodes.push_back(Node((int)(nextRandom() % 2147483647ULL)));
+        Node *added = &s.nodes.back();
+        if (i == 0)
+        {
+            continue;
+        }
+        Node *c = &s.nodes[0];
+        int depth = 1;
+        while (true)
+        {
+            Node *&next = (added->key < c->key) ? c->left : c->right;
+            if (next == nullptr)
+            {
+                next = added;
+                break;
+            }
+            c = next;
+            ++depth;
+        }
+        if (depth > s.height)
+        {
+            s.height = depth;
+        }
+    }
+}
+
+/**
+ * Builds a chain of n nodes linked through their left children.
+ */
+static void buildSkewed(Shape &s, int n)
+{
+    s.nodes.reserve(n);
+    for (int i = 0; i < n; ++i)
+    {
+        s.nodes.push_back(Node(i));
+    }
+    for (int i = 0; i + 1 < n; ++i)
+    {
+        s.nodes[i].left = &s.nodes[i + 1];
+    }
+    s.height = n - 1;
+}
+
+/**
+ * Returns the best of three runs of check(root) in milliseconds and stores
+ * its result.
+ */
+template <typename Check>
+static double timeCheck(Check check, Node *root, bool &result)
+{
+    double best = 0;
+    for (int run = 0; run < 3; ++run)
+    {
+        uint64_t start = LatencyClock::now();
+        result = check(root);
+        double ms = (double)LatencyClock::toNanos(LatencyClock::now() - start) / 1e6;
+        if (run == 0 || ms < best)
+        {
+            best = ms;
+        }
+    }
+    return best;
+}
+
+static void printShape(Shape &s, unsigned threads)
+{
+    bool result = false;
+    cout << left << setw(10) << s.name << right << setw(11) << s.nodes.size() << setw(9) << s.height;
+    if (s.height <= MAX_RECURSION_DEPTH)
+    {
+        cout << setw(12) << timeCheck(recursiveEqualPaths, s.root(), result);
+    }
+    else
+    {
+        cout << setw(12) << "too deep";
+    }
+    cout << setw(12) << timeCheck(equalPaths, s.root(), result);
+    cout << setw(12) << timeCheck([threads](Node *root) { return equalPathsParallel(root, threads); }, s.root(),
+                                  result);
+    cout << setw(8) << (result ? "true" : "false") << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    int n = 1 << 22;
+    unsigned threads = thread::hardware_concurrency();
+
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        if (arg == "-n" && i + 1 < argc)
+        {
+            n = atoi(argv[++i]);
+        }
+        else if (arg == "-threads" && i + 1 < argc)
+        {
+            threads = (unsigned)atoi(argv[++i]);
+        }
+        else if (arg == "-seed" && i + 1 < argc)
+        {
+            rngState = strtoull(argv[++i], NULL, 10) | 1;
+        }
+        else
+        {
+            cerr << "usage: " << argv[0] << " [-n N] [-threads T] [-seed S]" << endl;
+            return 1;
+        }
+    }
+    if (n < 1)
+    {
+        n = 1;
+    }
+
+    cout << "ms per check, best of 3, parallel with " << threads << " threads" << endl;
+    cout << fixed << setprecision(3) << left << setw(10) << "shape" << right << setw(11) << "nodes" << setw(9)
+         << "height" << setw(12) << "recursive" << setw(12) << "iterative" << setw(12) << "parallel" << setw(8)
+         << "result" << endl;
+    const char *names[] = {"balanced", "late", "random", "skewed"};
+    for (int i = 0; i < 4; ++i)
+    {
+        Shape s;
+        s.name = names[i];
+        if (i == 0 || i == 1)
+        {
+            buildPerfect(s, n, i == 1);
+        }
+        else if (i == 2)
+        {
+            buildRandom(s, n);
+        }
+        else
+        {
+            buildSkewed(s, n);
+        }
+        printShape(s, threads);
+    }
+    return 0;
+}
@@ -0,0 +1,18 @@
+#ifndef EQUAL_PATHS_PARALLEL_H
+#define EQUAL_PATHS_PARALLEL_H
+#include "equal-paths.h"
+
+/**
+ * @brief Same result as equalPaths(root), but the subtrees a few levels
+ *        below the root are checked on separate threads. All threads stop
+ *        as soon as any of them finds a leaf at a different depth.
+ *
+ *        Trees too narrow to split (e.g. a long chain) are checked on the
+ *        calling thread.
+ *
+ * @param root Pointer to the root of the tree to check for equal paths
+ * @param threads Number of threads to use; 0 picks the hardware concurrency
+ */
+bool equalPathsParallel(Node * root, unsigned threads = 0);
+
+#endif
@@ -1,6 +1,8 @@
 #include <iostream>
 #include <cstdlib>
+#include <vector>
 #include "equal-paths.h"
+#include "equal-paths-parallel.h"
 using namespace std;
 
 
@@ -55,6 +57,30 @@ void test5(const char* msg)
   cout << msg << ": " <<   equalPaths(a) << endl;
 }
 
+void test6(const char* msg)
+{
+  // a chain far deeper than the call stack allows recursing through
+  std::vector<Node> chain(1000000, Node(0));
+  for(size_t i = 0; i + 1 < chain.size(); ++i) {
+    chain[i].left = &chain[i + 1];
+  }
+  cout << msg << ": " <<   equalPaths(&chain[0]) << endl;
+}
+
+void test7(const char* msg)
+{
+  // perfect tree of depth 12, checked on 4 threads, then with one extra leaf
+  std::vector<Node> nodes((1 << 13) - 1, Node(0));
+  for(size_t i = 0; 2 * i + 2 < nodes.size(); ++i) {
+    nodes[i].left = &nodes[2 * i + 1];
+    nodes[i].right = &nodes[2 * i + 2];
+  }
+  cout << msg << ": " <<   equalPathsParallel(&nodes[0], 4);
+  Node extra(1);
+  nodes[nodes.size() / 2].left = &extra;
+  cout << " " <<   equalPathsParallel(&nodes[0], 4) << endl;
+}
+
 int main()
 {
   a = new Node(1);
@@ -67,6 +93,8 @@ int main()
   test3("Test3");
   test4("Test4");
   test5("Test5");
+  test6("Test6");
+  test7("Test7");
  
   delete a;
   delete b;
@@ -1,35 +1,191 @@
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <vector>
 #include "equal-paths.h"
+#include "equal-paths-parallel.h"
 using namespace std;
 
 // You may add any prototypes of helper functions here
 
-bool check(int lev, Node *root, int *leaf)
+namespace
 {
-	
-    // Base case
-    if (root == NULL)
-    {
-        return true;
-    }
-		int zero = 0; 
-    if (root->right == nullptr && root->left == nullptr)
+
+// A node waiting on the explicit stack, with its depth below the root
+typedef pair<Node *, int> Frame;
+
+// How many nodes a worker checks between looks at whether another failed
+const unsigned CANCEL_CHECK_INTERVAL = 4096;
+
+// Subtrees handed out per thread, so uneven subtrees still balance out
+const size_t SUBTREES_PER_THREAD = 8;
+
+// How far below the root the parallel version looks for subtrees to split
+const int MAX_SPLIT_DEPTH = 32;
+
+/**
+ * Depth-first walk of the subtree at n using an explicit stack, so deep or
+ * degenerate trees cannot overflow the call stack. The walk follows left
+ * children first and only stacks the right children it passes, passes every
+ * leaf's depth to leaf(depth), and stops as soon as leaf() returns false.
+ * If failed is not null it is polled so that the walk also stops once
+ * another thread has found a mismatch.
+ */
+template <typename Leaf>
+bool walk(Node *n, int depth, Leaf &leaf, const atomic<bool> *failed)
+{
+    vector<Frame> stack;
+    stack.reserve(64);
+    unsigned untilPoll = CANCEL_CHECK_INTERVAL;
+    while (true)
     {
-        if (*leaf == (0+zero))
+        if (n->left == nullptr && n->right == nullptr)
         {
-            *leaf = lev;
-            return true;
+            if (!leaf(depth))
+            {
+                return false;
+            }
+            if (stack.empty())
+            {
+                return true;
+            }
+            n = stack.back().first;
+            depth = stack.back().second;
+            stack.pop_back();
+        }
+        else if (n->left != nullptr)
+        {
+            if (n->right != nullptr)
+            {
+                stack.push_back(Frame(n->right, depth + 1));
+            }
+            n = n->left;
+            ++depth;
+        }
+        else
+        {
+            n = n->right;
+            ++depth;
+        }
+        if (failed != nullptr && --untilPoll == 0)
+        {
+            if (failed->load(memory_order_relaxed))
+            {
+                return false;
+            }
+            untilPoll = CANCEL_CHECK_INTERVAL;
         }
-
-        bool checker = (lev == *leaf);
-        return checker;
     }
-    return check((lev + 1 + zero), root->right, leaf) && check(lev + 1 + zero, root->left, leaf);
 }
 
+/**
+ * The leaf depth shared by all threads: the first leaf recorded fixes it
+ * and every later leaf must match it.
+ */
+struct SharedLeafDepth
+{
+    atomic<int> depth;
+
+    SharedLeafDepth() : depth(-1) {}
+
+    bool operator()(int d)
+    {
+        int expected = -1;
+        return depth.compare_exchange_strong(expected, d) || expected == d;
+    }
+};
+
+} // namespace
+
 bool equalPaths(Node *root)
 {
-    // Add your code below
-    int lev = 0 * 1;
-    int leafLevel = 0 * 0;
-    return check(lev, root, &leafLevel);
+    if (root == nullptr)
+    {
+        return true;
+    }
+    int leafLevel = -1;
+    auto leaf = [&leafLevel](int d) {
+        if (leafLevel < 0)
+        {
+            leafLevel = d;
+        }
+        return d == leafLevel;
+    };
+    return walk(root, 0, leaf, nullptr);
+}
+
+/**
+ * Expands the tree level by level until there are enough subtrees to keep
+ * every thread busy, then lets the threads take subtrees from a shared
+ * counter. Leaves met while expanding are checked on the way.
+ */
+bool equalPathsParallel(Node *root, unsigned threads)
+{
+    if (threads == 0)
+    {
+        threads = thread::hardware_concurrency();
+    }
+    if (root == nullptr || threads <= 1)
+    {
+        return equalPaths(root);
+    }
+
+    SharedLeafDepth leaf;
+    vector<Frame> frontier(1, Frame(root, 0));
+    size_t target = threads * SUBTREES_PER_THREAD;
+    for (int level = 0; level < MAX_SPLIT_DEPTH && !frontier.empty() && frontier.size() < target; ++level)
+    {
+        vector<Frame> next;
+        for (size_t i = 0; i < frontier.size(); ++i)
+        {
+            Node *n = frontier[i].first;
+            if (n->left == nullptr && n->right == nullptr)
+            {
+                if (!leaf(frontier[i].second))
+                {
+                    return false;
+                }
+                continue;
+            }
+            if (n->left != nullptr)
+            {
+                next.push_back(Frame(n->left, frontier[i].second + 1));
+            }
+            if (n->right != nullptr)
+            {
+                next.push_back(Frame(n->right, frontier[i].second + 1));
+            }
+        }
+        frontier.swap(next);
+    }
+    if (frontier.size() <= 1)
+    {
+        return frontier.empty() || walk(frontier[0].first, frontier[0].second, leaf, nullptr);
+    }
+
+    atomic<bool> failed(false);
+    atomic<size_t> nextTask(0);
+    auto worker = [&]() {
+        size_t i;
+        while (!failed.load(memory_order_relaxed) && (i = nextTask.fetch_add(1)) < frontier.size())
+        {
+            if (!walk(frontier[i].first, frontier[i].second, leaf, &failed))
+            {
+                failed.store(true);
+            }
+        }
+    };
+    vector<thread> pool;
+    size_t helpers = min<size_t>(threads, frontier.size()) - 1;
+    for (size_t t = 0; t < helpers; ++t)
+    {
+        pool.push_back(thread(worker));
+    }
+    worker();
+    for (size_t t = 0; t < pool.size(); ++t)
+    {
+        pool[t].join();
+    }
+    return !failed.load();
 }
@@ -0,0 +1,289 @@
+#ifndef EXPORT_BST_H
+#define EXPORT_BST_H
+
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+// Streaming exporters for whole trees or subtrees of any size. Unlike
+// printRoot, they hold nothing but a few pointers while they run: the walk
+// follows parent links instead of keeping a stack or whole rows, and every
+// node is written out as soon as it is reached. Nodes are named by their
+// addresses, which stay the same for one run of the program. Keys and values
+// are written with operator<<.
+
+// Helpers for the exporters below, kept out of the global namespace of
+// every file that includes bst.h.
+namespace bst_detail
+{
+
+/*
+ * Appends text to line as the inside of a quoted string, escaping what DOT
+ * or (with json) JSON would otherwise misread.
+ */
+inline void appendEscaped(std::string &line, const std::string &text, bool json)
+{
+    static const char hex[] = "0123456789abcdef";
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        char c = text[i];
+        if (c == '"' || c == '\\')
+        {
+            line += '\\';
+            line += c;
+        }
+        else if (c == '\n')
+        {
+            line += "\\n";
+        }
+        else if (json && (unsigned char)c < 0x20)
+        {
+            line += "\\u00";
+            line += hex[(c >> 4) & 0xf];
+            line += hex[c & 0xf];
+        }
+        else
+        {
+            line += c;
+        }
+    }
+}
+
+/*
+ * Formats x the way operator<< would. Integers other than the character
+ * types skip the string stream, which dominates the cost of an export
+ * otherwise; std::to_string gives the same digits for them. Floating point
+ * (which to_string rounds to six decimals) and the character types (which
+ * operator<< writes as characters) go through the stream.
+ */
+template <typename T>
+void formatText(std::string &text, std::ostringstream &scratch, const T &x, std::true_type)
+{
+    (void)scratch;
+    text = std::to_string(x);
+}
+
+template <typename T>
+void formatText(std::string &text, std::ostringstream &scratch, const T &x, std::false_type)
+{
+    scratch.str(std::string());
+    scratch << x;
+    text = scratch.str();
+}
+
+/*
+ * Whether T is an integer type that operator<< writes as a number: not
+ * bool and not one of the character types.
+ */
+template <typename T>
+struct isPlainInteger
+    : std::integral_constant<bool, std::is_integral<T>::value && !std::is_same<T, bool>::value &&
+                                       !std::is_same<T, char>::value && !std::is_same<T, signed char>::value &&
+                                       !std::is_same<T, unsigned char>::value && !std::is_same<T, wchar_t>::value &&
+                                       !std::is_same<T, char16_t>::value && !std::is_same<T, char32_t>::value>
+{
+};
+
+/*
+ * Appends x to line as an escaped quoted string.
+ */
+template <typename T>
+void appendQuoted(std::string &line, std::string &text, std::ostringstream &scratch, const T &x, bool json)
+{
+    formatText(text, scratch, x, std::integral_constant<bool, isPlainInteger<T>::value>());
+    line += '"';
+    appendEscaped(line, text, json);
+    line += '"';
+}
+
+/*
+ * Appends the address of p in hex, which names its node in the output.
+ */
+inline void appendId(std::string &line, const void *p)
+{
+    static const char hex[] = "0123456789abcdef";
+    char digits[2 * sizeof(size_t)];
+    size_t v = (size_t)p;
+    int i = (int)sizeof(digits);
+    do
+    {
+        digits[--i] = hex[v & 0xf];
+        v >>= 4;
+    } while (v != 0);
+    line += "\"0x";
+    line.append(digits + i, sizeof(digits) - i);
+    line += '"';
+}
+
+} // namespace bst_detail
+
+/**
+ * Calls visit(node, depth) on every node of the subtree at top down to
+ * maxDepth levels below it (top itself is at depth 0), in pre-order. Uses
+ * O(1) memory: after a leaf (or a node at the depth limit) it climbs the
+ * parent links to the next right subtree still to visit.
+ */
+template <typename Key, typename Value>
+template <typename Visit>
+void BinarySearchTree<Key, Value>::walkPreorder(Node<Key, Value> *top, size_t maxDepth, Visit visit)
+{
+    Node<Key, Value> *n = top;
+    size_t depth = 0;
+    while (n != NULL)
+    {
+        visit(n, depth);
+        if (depth < maxDepth && n->getLeft() != NULL)
+        {
+            n = n->getLeft();
+            ++depth;
+            continue;
+        }
+        if (depth < maxDepth && n->getRight() != NULL)
+        {
+            n = n->getRight();
+            ++depth;
+            continue;
+        }
+
+        // climb until coming up out of a left subtree whose parent has a
+        // right subtree, which is the next one to visit
+        Node<Key, Value> *next = NULL;
+        while (n != top && next == NULL)
+        {
+            Node<Key, Value> *p = n->getParent();
+            --depth;
+            if (p->getLeft() == n && p->getRight() != NULL)
+            {
+                next = p->getRight();
+                ++depth;
+            }
+            n = p;
+        }
+        n = next;
+    }
+}
+
+/**
+ * Writes the whole tree as a Graphviz digraph; see writeDotFrom().
+ */
+template <typename Key, typename Value>
+void BinarySearchTree<Key, Value>::writeDot(std::ostream &out, size_t maxDepth) const
+{
+    pushSubtree(root_, maxDepth);
+    writeDotFrom(out, root_, maxDepth);
+}
+
+/**
+ * Writes the subtree under the item subtree points to as a Graphviz digraph.
+ */
+template <typename Key, typename Value>
+void BinarySearchTree<Key, Value>::writeDot(std::ostream &out, const iterator &subtree, size_t maxDepth) const
+{
+    pushSubtree(subtree.current_, maxDepth);
+    writeDotFrom(out, subtree.current_, maxDepth);
+}
+
+/**
+ * Writes the whole tree as newline-delimited JSON; see writeJsonLinesFrom().
+ */
+template <typename Key, typename Value>
+void BinarySearchTree<Key, Value>::writeJsonLines(std::ostream &out, size_t maxDepth) const
+{
+    pushSubtree(root_, maxDepth);
+    writeJsonLinesFrom(out, root_, maxDepth);
+}
+
+/**
+ * Writes the subtree under the item subtree points to as newline-delimited
+ * JSON.
+ */
+template <typename Key, typename Value>
+void BinarySearchTree<Key, Value>::writeJsonLines(std::ostream &out, const iterator &subtree,
+                                                  size_t maxDepth) const
+{
+    pushSubtree(subtree.current_, maxDepth);
+    writeJsonLinesFrom(out, subtree.current_, maxDepth);
+}
+
+/**
+ * Writes one DOT node per tree node, labelled with its key, and one edge to
+ * each child, leaving the parent from its lower left or lower right so that
+ * a lone child still shows its side. Nodes at maxDepth whose children were
+ * left out are drawn dashed.
+ */
+template <typename Key, typename Value>
+void BinarySearchTree<Key, Value>::writeDotFrom(std::ostream &out, Node<Key, Value> *top, size_t maxDepth)
+{
+    std::ostringstream scratch;
+    std::string line, text;
+    out << "digraph bst {\n  node [shape=box];\n";
+    walkPreorder(top, maxDepth, [&](Node<Key, Value> *n, size_t depth) {
+        bool cut = depth == maxDepth && (n->getLeft() != NULL || n->getRight() != NULL);
+        line.assign("  ");
+        bst_detail::appendId(line, n);
+        line += " [label=";
+        bst_detail::appendQuoted(line, text, scratch, n->getKey(), false);
+        line += cut ? ", style=dashed];\n" : "];\n";
+        if (depth < maxDepth && n->getLeft() != NULL)
+        {
+            line += "  ";
+            bst_detail::appendId(line, n);
+            line += ":sw -> ";
+            bst_detail::appendId(line, n->getLeft());
+            line += ";\n";
+        }
+        if (depth < maxDepth && n->getRight() != NULL)
+        {
+            line += "  ";
+            bst_detail::appendId(line, n);
+            line += ":se -> ";
+            bst_detail::appendId(line, n->getRight());
+            line += ";\n";
+        }
+        out.write(line.data(), line.size());
+    });
+    out << "}\n";
+}
+
+/**
+ * Writes one JSON object per line for every node, in pre-order:
+ *   {"id":"0x..","depth":0,"key":"..","value":"..","parent":null,"left":"0x..","right":null}
+ * Keys and values are written as strings. left and right name the children
+ * even when maxDepth leaves them out, so a reader can tell where the export
+ * was cut.
+ */
+template <typename Key, typename Value>
+void BinarySearchTree<Key, Value>::writeJsonLinesFrom(std::ostream &out, Node<Key, Value> *top, size_t maxDepth)
+{
+    std::ostringstream scratch;
+    std::string line, text;
+    walkPreorder(top, maxDepth, [&](Node<Key, Value> *n, size_t depth) {
+        line.assign("{\"id\":");
+        bst_detail::appendId(line, n);
+        line += ",\"depth\":";
+        line += std::to_string(depth);
+        line += ",\"key\":";
+        bst_detail::appendQuoted(line, text, scratch, n->getKey(), true);
+        line += ",\"value\":";
+        bst_detail::appendQuoted(line, text, scratch, n->getValue(), true);
+        Node<Key, Value> *links[3] = {(n == top) ? NULL : n->getParent(), n->getLeft(), n->getRight()};
+        const char *names[3] = {",\"parent\":", ",\"left\":", ",\"right\":"};
+        for (int i = 0; i < 3; ++i)
+        {
+            line += names[i];
+            if (links[i] == NULL)
+            {
+                line += "null";
+            }
+            else
+            {
+                bst_detail::appendId(line, links[i]);
+            }
+        }
+        line += "}\n";
+        out.write(line.data(), line.size());
+    });
+}
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef INDEXAVLBST_H
+#define INDEXAVLBST_H
+
+#include <cstdint>
+#include <utility>
+#include "slotavlbst.h"
+
+/**
+ * An AVL tree whose nodes live in slots of a few heap blocks and link to
+ * each other with 32-bit slot indices instead of 64-bit pointers. A slot for
+ * int keys and values is 24 bytes (item, three links and the balance, no
+ * vtable) against 48 for an AVLNode plus the allocator's header, nodes
+ * inserted together sit next to each other in memory, and removed slots are
+ * reused through a free list threaded through their parent links.
+ *
+ * The public interface and iterator semantics match AVLTree: items never
+ * move once inserted, so iterators and references to other items stay valid
+ * across inserts and removes. Holds fewer than 2^32 - 1 items. The tree
+ * itself is SlotAVLTree over BlockSlots, which it shares with StaticAVLTree.
+ */
+template <class Key, class Value>
+class IndexedAVLTree : public SlotAVLTree<Key, Value, BlockSlots<std::pair<const Key, Value>, uint32_t> >
+{
+};
+
+#endif
@@ -0,0 +1,248 @@
+#ifndef INTERVALBST_H
+#define INTERVALBST_H
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "augavlbst.h"
+
+/**
+ * A closed interval [start, end], which is the key of an IntervalTree.
+ * Intervals are ordered by start and then by end.
+ */
+template <typename T>
+struct Interval
+{
+    T start;
+    T end;
+
+    Interval() : start(), end() {}
+    Interval(const T &s, const T &e) : start(s), end(e) {}
+};
+
+template <typename T>
+bool operator<(const Interval<T> &a, const Interval<T> &b)
+{
+    return a.start < b.start || (!(b.start < a.start) && a.end < b.end);
+}
+
+template <typename T>
+bool operator>(const Interval<T> &a, const Interval<T> &b)
+{
+    return b < a;
+}
+
+template <typename T>
+bool operator==(const Interval<T> &a, const Interval<T> &b)
+{
+    return !(a < b) && !(b < a);
+}
+
+template <typename T>
+bool operator!=(const Interval<T> &a, const Interval<T> &b)
+{
+    return !(a == b);
+}
+
+template <typename T>
+std::ostream &operator<<(std::ostream &os, const Interval<T> &i)
+{
+    return os << "[" << i.start << "," << i.end << "]";
+}
+
+/**
+ * The monoid an IntervalTree aggregates: the largest end point of the
+ * intervals in a subtree.
+ */
+template <typename T>
+struct MaxEndMonoid
+{
+    typedef T value_type;
+    static T identity() { return std::numeric_limits<T>::lowest(); }
+    static T combine(const T &a, const T &b) { return (a < b) ? b : a; }
+    template <typename V>
+    static T lift(const Interval<T> &key, const V &) { return key.end; }
+};
+
+/**
+ * An interval tree over closed intervals: an AVL tree keyed by Interval, so
+ * intervals sharing a start are kept apart, in which every node also keeps
+ * the largest end point below it. Overlap searches prune
+ * every subtree whose largest end is left of the query and, through the
+ * ordering, every subtree whose intervals all start right of it. Reporting
+ * k overlaps visits O((k + 1) log n) nodes in the worst case; the reported
+ * intervals share most of their paths, which usually brings this close to
+ * O(log n + k).
+ */
+template <class T, class Value>
+class IntervalTree : public AugmentedAVLTree<Interval<T>, Value, MaxEndMonoid<T> >
+{
+public:
+    typedef typename BinarySearchTree<Interval<T>, Value>::iterator iterator;
+
+    IntervalTree();
+    explicit IntervalTree(NodeResource *resource);
+    virtual ~IntervalTree();
+
+    void insert(const T &start, const T &end, const Value &value);
+    using AugmentedAVLTree<Interval<T>, Value, MaxEndMonoid<T> >::insert;
+    void remove(const T &start, const T &end);
+    using AugmentedAVLTree<Interval<T>, Value, MaxEndMonoid<T> >::remove;
+
+    template <typename Visit>
+    void forEachOverlap(const T &lo, const T &hi, Visit visit) const;
+    void overlapping(const T &lo, const T &hi, std::vector<iterator> &out) const;
+    void stab(const T &point, std::vector<iterator> &out) const;
+    bool overlapsAny(const T &lo, const T &hi) const;
+
+protected:
+    typedef typename AugmentedAVLTree<Interval<T>, Value, MaxEndMonoid<T> >::NodeType NodeType;
+
+    // Helper functions
+    template <typename Visit>
+    void visitOverlaps(NodeType *n, const T &lo, const T &hi, Visit &visit) const;
+};
+
+/*
+  ---------------------------------------------------
+  Begin implementations for the IntervalTree class.
+  ---------------------------------------------------
+*/
+
+template <class T, class Value>
+IntervalTree<T, Value>::IntervalTree()
+{
+}
+
+/**
+ * Constructor for a tree whose nodes are allocated from resource.
+ */
+template <class T, class Value>
+IntervalTree<T, Value>::IntervalTree(NodeResource *resource)
+    : AugmentedAVLTree<Interval<T>, Value, MaxEndMonoid<T> >(resource)
+{
+}
+
+/**
+ * Clears the tree here so that destroyNode still sees the full node type.
+ */
+template <class T, class Value>
+IntervalTree<T, Value>::~IntervalTree()
+{
+    this->clear();
+}
+
+/**
+ * Adds the interval [start, end] with its value; inserting an interval that
+ * is already present overwrites its value.
+ */
+template <class T, class Value>
+void IntervalTree<T, Value>::insert(const T &start, const T &end, const Value &value)
+{
+    if (end < start)
+    {
+        throw std::invalid_argument("interval end is before its start");
+    }
+    this->insert(std::pair<const Interval<T>, Value>(Interval<T>(start, end), value));
+}
+
+/**
+ * Removes the interval [start, end] if it is present.
+ */
+template <class T, class Value>
+void IntervalTree<T, Value>::remove(const T &start, const T &end)
+{
+    this->remove(Interval<T>(start, end));
+}
+
+/**
+ * Calls visit(iterator) for every interval overlapping [lo, hi], in order
+ * of (start, end).
+ */
+template <class T, class Value>
+template <typename Visit>
+void IntervalTree<T, Value>::forEachOverlap(const T &lo, const T &hi, Visit visit) const
+{
+    visitOverlaps(static_cast<NodeType *>(this->root_), lo, hi, visit);
+}
+
+/**
+ * Appends an iterator to every interval overlapping [lo, hi] to out.
+ */
+template <class T, class Value>
+void IntervalTree<T, Value>::overlapping(const T &lo, const T &hi, std::vector<iterator> &out) const
+{
+    forEachOverlap(lo, hi, [&out](const iterator &it) { out.push_back(it); });
+}
+
+/**
+ * Appends an iterator to every interval containing point to out.
+ */
+template <class T, class Value>
+void IntervalTree<T, Value>::stab(const T &point, std::vector<iterator> &out) const
+{
+    overlapping(point, point, out);
+}
+
+/**
+ * Returns true if some interval overlaps [lo, hi], in O(log n): among the
+ * intervals starting at or before hi, only the largest end point matters.
+ */
+template <class T, class Value>
+bool IntervalTree<T, Value>::overlapsAny(const T &lo, const T &hi) const
+{
+    T best = MaxEndMonoid<T>::identity();
+    bool any = false;
+    for (NodeType *c = static_cast<NodeType *>(this->root_); c != nullptr;)
+    {
+        if (hi < c->getKey().start)
+        {
+            c = c->getLeft();
+            continue;
+        }
+        // c and its whole left subtree start at or before hi
+        any = true;
+        best = MaxEndMonoid<T>::combine(best, c->getKey().end);
+        if (c->getLeft() != nullptr)
+        {
+            best = MaxEndMonoid<T>::combine(best, c->getLeft()->getAggregate());
+        }
+        c = c->getRight();
+    }
+    return any && !(best < lo);
+}
+
+/**
+ * In-order search below n that skips subtrees ending before lo and, past a
+ * node starting after hi, everything to its right.
+ */
+template <class T, class Value>
+template <typename Visit>
+void IntervalTree<T, Value>::visitOverlaps(NodeType *n, const T &lo, const T &hi, Visit &visit) const
+{
+    if (n == nullptr || n->getAggregate() < lo)
+    {
+        return;
+    }
+    visitOverlaps(n->getLeft(), lo, hi, visit);
+    if (hi < n->getKey().start)
+    {
+        return;
+    }
+    if (!(n->getKey().end < lo))
+    {
+        visit(this->iteratorAt(n));
+    }
+    visitOverlaps(n->getRight(), lo, hi, visit);
+}
+
+/*
+  -------------------------------------------------
+  End implementations for the IntervalTree class.
+  -------------------------------------------------
+*/
+
+#endif
@@ -0,0 +1,221 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * A low-overhead log-linear latency histogram (in the style of HdrHistogram).
+ * Values below 2^SUB_BITS are counted exactly; larger values fall into one of
+ * 2^SUB_BITS linear sub-buckets per power of two, so every recorded value is
+ * kept to within ~3% of its true magnitude. Recording is a handful of integer
+ * instructions and never allocates.
+ */
+class LatencyHistogram
+{
+public:
+    static const unsigned SUB_BITS = 5;
+    static const uint64_t SUB_COUNT = (uint64_t)1 << SUB_BITS;
+    static const size_t BUCKETS = (64 - SUB_BITS + 1) * SUB_COUNT;
+
+    LatencyHistogram();
+
+    void record(uint64_t value);
+    void merge(const LatencyHistogram &other);
+    void reset();
+
+    uint64_t count() const;
+    uint64_t max() const;
+    double mean() const;
+    uint64_t percentile(double p) const;
+
+private:
+    static size_t bucketIndex(uint64_t value);
+    static uint64_t bucketUpperBound(size_t index);
+
+    uint64_t counts_[BUCKETS];
+    uint64_t total_;
+    uint64_t max_;
+    double sum_;
+};
+
+/**
+ * Default constructor, which starts with every bucket empty.
+ */
+inline LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+/**
+ * Maps a value to its bucket: exact for small values, otherwise the exponent
+ * selects a block of SUB_COUNT buckets and the next SUB_BITS bits select one.
+ */
+inline size_t LatencyHistogram::bucketIndex(uint64_t value)
+{
+    if (value < SUB_COUNT)
+    {
+        return (size_t)value;
+    }
+    unsigned msb = 63 - (unsigned)__builtin_clzll(value);
+    unsigned shift = msb - SUB_BITS;
+    return (size_t)(((uint64_t)(shift + 1) << SUB_BITS) | ((value >> shift) & (SUB_COUNT - 1)));
+}
+
+/**
+ * Returns the largest value that lands in the given bucket.
+ */
+inline uint64_t LatencyHistogram::bucketUpperBound(size_t index)
+{
+    if (index < SUB_COUNT)
+    {
+        return (uint64_t)index;
+    }
+    unsigned shift = (unsigned)(index >> SUB_BITS) - 1;
+    uint64_t low = ((index & (SUB_COUNT - 1)) | SUB_COUNT) << shift;
+    return low + (((uint64_t)1 << shift) - 1);
+}
+
+/**
+ * Adds a single sample.
+ */
+inline void LatencyHistogram::record(uint64_t value)
+{
+    ++counts_[bucketIndex(value)];
+    ++total_;
+    sum_ += (double)value;
+    if (value > max_)
+    {
+        max_ = value;
+    }
+}
+
+/**
+ * Folds the samples of another histogram into this one.
+ */
+inline void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    for (size_t i = 0; i < BUCKETS; ++i)
+    {
+        counts_[i] += other.counts_[i];
+    }
+    total_ += other.total_;
+    sum_ += other.sum_;
+    max_ = std::max(max_, other.max_);
+}
+
+/**
+ * Discards every sample.
+ */
+inline void LatencyHistogram::reset()
+{
+    std::memset(counts_, 0, sizeof(counts_));
+    total_ = 0;
+    max_ = 0;
+    sum_ = 0.0;
+}
+
+inline uint64_t LatencyHistogram::count() const
+{
+    return total_;
+}
+
+inline uint64_t LatencyHistogram::max() const
+{
+    return max_;
+}
+
+inline double LatencyHistogram::mean() const
+{
+    return total_ == 0 ? 0.0 : sum_ / (double)total_;
+}
+
+/**
+ * Returns the value at or below which p percent (0-100) of the samples fall,
+ * rounded up to the top of its bucket and clamped to the true maximum.
+ */
+inline uint64_t LatencyHistogram::percentile(double p) const
+{
+    if (total_ == 0)
+    {
+        return 0;
+    }
+    uint64_t rank = (uint64_t)((p / 100.0) * (double)total_ + 0.5);
+    if (rank < 1)
+    {
+        rank = 1;
+    }
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; ++i)
+    {
+        seen += counts_[i];
+        if (seen >= rank)
+        {
+            return std::min(bucketUpperBound(i), max_);
+        }
+    }
+    return max_;
+}
+
+/**
+ * A cheap timestamp source for per-call latency measurement. On x86 this reads
+ * the time-stamp counter and converts ticks to nanoseconds with a factor that
+ * is calibrated once against steady_clock; elsewhere it falls back to
+ * steady_clock directly.
+ */
+class LatencyClock
+{
+public:
+    static uint64_t now();
+    static double nanosPerTick();
+    static uint64_t toNanos(uint64_t ticks);
+};
+
+inline uint64_t LatencyClock::now()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return (uint64_t)__rdtsc();
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+inline double LatencyClock::nanosPerTick()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    static double factor = 0.0;
+    if (factor == 0.0)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        uint64_t ticks = now();
+        std::chrono::steady_clock::time_point stop;
+        do
+        {
+            stop = std::chrono::steady_clock::now();
+        } while (stop - start < std::chrono::milliseconds(20));
+        ticks = now() - ticks;
+        double nanos = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+        factor = nanos / (double)(ticks == 0 ? 1 : ticks);
+    }
+    return factor;
+#else
+    return 1.0;
+#endif
+}
+
+inline uint64_t LatencyClock::toNanos(uint64_t ticks)
+{
+    return (uint64_t)((double)ticks * nanosPerTick() + 0.5);
+}
+
+#endif
@@ -0,0 +1,524 @@
+#ifndef LAZYAVLBST_H
+#define LAZYAVLBST_H
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <vector>
+#include "augavlbst.h"
+
+/**
+ * A pending range update: optionally set every value to `value`, then add
+ * `add` to every value.
+ */
+template <typename Value>
+struct RangeTag
+{
+    bool assign;
+    Value value;
+    Value add;
+
+    RangeTag() : assign(false), value(), add() {}
+};
+
+/**
+ * An AugAVLNode that also stores its subtree size and the range update still
+ * pending for its children. The node's own value and aggregate already
+ * include every update applied to it.
+ */
+template <typename Key, typename Value, typename Agg>
+class LazyAVLNode : public AugAVLNode<Key, Value, Agg>
+{
+public:
+    // Constructor/destructor.
+    LazyAVLNode(const Key &key, const Value &value, LazyAVLNode<Key, Value, Agg> *parent);
+    virtual ~LazyAVLNode();
+
+    // Getter/setter for the subtree size.
+    size_t getSize() const;
+    void setSize(size_t size);
+
+    // Access to the update pending for the children.
+    bool hasTag() const;
+    const RangeTag<Value> &getTag() const;
+    void setTag(const RangeTag<Value> &tag);
+    void clearTag();
+
+    // Getters for parent, left, and right, returning LazyAVLNodes.
+    virtual LazyAVLNode<Key, Value, Agg> *getParent() const override;
+    virtual LazyAVLNode<Key, Value, Agg> *getLeft() const override;
+    virtual LazyAVLNode<Key, Value, Agg> *getRight() const override;
+
+protected:
+    size_t size_;
+    bool pending_;
+    RangeTag<Value> tag_;
+};
+
+/*
+  ---------------------------------------------------
+  Begin implementations for the LazyAVLNode class.
+  ---------------------------------------------------
+*/
+
+/**
+ * An explicit constructor for a leaf with nothing pending.
+ */
+template <typename Key, typename Value, typename Agg>
+LazyAVLNode<Key, Value, Agg>::LazyAVLNode(const Key &key, const Value &value, LazyAVLNode<Key, Value, Agg> *parent)
+    : AugAVLNode<Key, Value, Agg>(key, value, parent), size_(1), pending_(false), tag_()
+{
+}
+
+/**
+ * A destructor which does nothing.
+ */
+template <typename Key, typename Value, typename Agg>
+LazyAVLNode<Key, Value, Agg>::~LazyAVLNode()
+{
+}
+
+/**
+ * A getter for the number of nodes in the subtree.
+ */
+template <typename Key, typename Value, typename Agg>
+size_t LazyAVLNode<Key, Value, Agg>::getSize() const
+{
+    return size_;
+}
+
+/**
+ * A setter for the number of nodes in the subtree.
+ */
+template <typename Key, typename Value, typename Agg>
+void LazyAVLNode<Key, Value, Agg>::setSize(size_t size)
+{
+    size_ = size;
+}
+
+/**
+ * Returns true if an update is waiting to be pushed to the children.
+ */
+template <typename Key, typename Value, typename Agg>
+bool LazyAVLNode<Key, Value, Agg>::hasTag() const
+{
+    return pending_;
+}
+
+/**
+ * A getter for the pending update.
+ */
+template <typename Key, typename Value, typename Agg>
+const RangeTag<Value> &LazyAVLNode<Key, Value, Agg>::getTag() const
+{
+    return tag_;
+}
+
+/**
+ * A setter for the pending update.
+ */
+template <typename Key, typename Value, typename Agg>
+void LazyAVLNode<Key, Value, Agg>::setTag(const RangeTag<Value> &tag)
+{
+    tag_ = tag;
+    pending_ = true;
+}
+
+/**
+ * Marks the children as up to date.
+ */
+template <typename Key, typename Value, typename Agg>
+void LazyAVLNode<Key, Value, Agg>::clearTag()
+{
+    tag_ = RangeTag<Value>();
+    pending_ = false;
+}
+
+/**
+ * Overridden so that a static_cast makes the parent a LazyAVLNode.
+ */
+template <typename Key, typename Value, typename Agg>
+LazyAVLNode<Key, Value, Agg> *LazyAVLNode<Key, Value, Agg>::getParent() const
+{
+    return static_cast<LazyAVLNode<Key, Value, Agg> *>(this->parent_);
+}
+
+/**
+ * Overridden for the same reasons as above.
+ */
+template <typename Key, typename Value, typename Agg>
+LazyAVLNode<Key, Value, Agg> *LazyAVLNode<Key, Value, Agg>::getLeft() const
+{
+    return static_cast<LazyAVLNode<Key, Value, Agg> *>(this->left_);
+}
+
+/**
+ * Overridden for the same reasons as above.
+ */
+template <typename Key, typename Value, typename Agg>
+LazyAVLNode<Key, Value, Agg> *LazyAVLNode<Key, Value, Agg>::getRight() const
+{
+    return static_cast<LazyAVLNode<Key, Value, Agg> *>(this->right_);
+}
+
+/*
+  -------------------------------------------------
+  End implementations for the LazyAVLNode class.
+  -------------------------------------------------
+*/
+
+/**
+ * An AugmentedAVLTree that can add a delta to, or assign a value to, every
+ * item in a key range in O(log n). A range update changes O(log n) nodes
+ * directly and leaves a tag on the roots of the whole subtrees it covers;
+ * tags are pushed one level down whenever a descent, an iterator step or a
+ * rotation passes through them, so every read below sees the update. Monoid
+ * must provide addAll and assignAll (SumMonoid, MinMonoid and MaxMonoid do).
+ *
+ * The pushes happen in BinarySearchTree's own lookups, updates and
+ * iterators through pushPending(), so they also run when the tree is used
+ * through a base class reference, and every operation keeps its usual
+ * cost: begin() and --end() descend from the root in O(log n) rather than
+ * using the cached ends. Values read through iterators obtained before a
+ * later range update may be stale. Finger searches fall back to searching
+ * from the root.
+ */
+template <class Key, class Value, class Monoid = SumMonoid<Value> >
+class LazyAVLTree : public AugmentedAVLTree<Key, Value, Monoid>
+{
+public:
+    typedef typename AugmentedAVLTree<Key, Value, Monoid>::Aggregate Aggregate;
+
+    LazyAVLTree();
+    explicit LazyAVLTree(NodeResource *resource);
+    virtual ~LazyAVLTree();
+
+    void rangeAdd(const Key &lo, const Key &hi, const Value &delta);
+    void rangeAssign(const Key &lo, const Key &hi, const Value &value);
+
+protected:
+    typedef LazyAVLNode<Key, Value, Aggregate> LazyNode;
+
+    virtual void nodeSwap(AVLNode<Key, Value> *n1, AVLNode<Key, Value> *n2);
+    virtual void removeNode(Node<Key, Value> *node);
+    virtual AVLNode<Key, Value> *newNode(const Key &key, const Value &value, AVLNode<Key, Value> *parent);
+    virtual AVLNode<Key, Value> *copyNode(void *where, AVLNode<Key, Value> *from);
+    virtual void refresh(AVLNode<Key, Value> *n);
+    virtual void pushDown(AVLNode<Key, Value> *n);
+    virtual void pushPending(Node<Key, Value> *n) const;
+
+    // Helper functions
+    void applyRange(const Key &lo, const Key &hi, const RangeTag<Value> &tag);
+    static void applyValue(LazyNode *n, const RangeTag<Value> &tag);
+    static void applyTag(LazyNode *n, const RangeTag<Value> &tag);
+    static void push(LazyNode *n);
+    LazyNode *pushPath(const Key &key) const;
+};
+
+/*
+  --------------------------------------------------
+  Begin implementations for the LazyAVLTree class.
+  --------------------------------------------------
+*/
+
+template <class Key, class Value, class Monoid>
+LazyAVLTree<Key, Value, Monoid>::LazyAVLTree()
+{
+    this->pushesPending_ = true;
+}
+
+/**
+ * Constructor for a tree whose nodes are allocated from resource.
+ */
+template <class Key, class Value, class Monoid>
+LazyAVLTree<Key, Value, Monoid>::LazyAVLTree(NodeResource *resource)
+    : AugmentedAVLTree<Key, Value, Monoid>(resource)
+{
+    this->pushesPending_ = true;
+}
+
+/**
+ * Clears the tree here so that destroyNode still sees the full node type.
+ */
+template <class Key, class Value, class Monoid>
+LazyAVLTree<Key, Value, Monoid>::~LazyAVLTree()
+{
+    this->clear();
+}
+
+/*
+ * Pushes the path to the node and, if it has two children, on to its
+ * predecessor, since remove() moves the predecessor up into its place.
+ */
+template <class Key, class Value, class Monoid>
+void LazyAVLTree<Key, Value, Monoid>::removeNode(Node<Key, Value> *node)
+{
+    LazyNode *n = pushPath(node->getKey());
+    if (n->getLeft() != nullptr && n->getRight() != nullptr)
+    {
+        for (LazyNode *c = n->getLeft(); c != nullptr; c = c->getRight())
+        {
+            push(c);
+        }
+    }
+    AVLTree<Key, Value>::removeNode(n);
+}
+
+/**
+ * Adds delta to the value of every item with a key in [lo, hi].
+ */
+template <class Key, class Value, class Monoid>
+void LazyAVLTree<Key, Value, Monoid>::rangeAdd(const Key &lo, const Key &hi, const Value &delta)
+{
+    RangeTag<Value> tag;
+    tag.add = delta;
+    applyRange(lo, hi, tag);
+}
+
+/**
+ * Sets the value of every item with a key in [lo, hi].
+ */
+template <class Key, class Value, class Monoid>
+void LazyAVLTree<Key, Value, Monoid>::rangeAssign(const Key &lo, const Key &hi, const Value &value)
+{
+    RangeTag<Value> tag;
+    tag.assign = true;
+    tag.value = value;
+    applyRange(lo, hi, tag);
+}
+
+/**
+ * Swaps two nodes as AugmentedAVLTree does, along with their sizes. Both
+ * have had their tags pushed by remove(), so there are none to swap.
+ */
+template <class Key, class Value, class Monoid>
+void LazyAVLTree<Key, Value, Monoid>::nodeSwap(AVLNode<Key, Value> *n1, AVLNode<Key, Value> *n2)
+{
+    AugmentedAVLTree<Key, Value, Monoid>::nodeSwap(n1, n2);
+    LazyNode *l1 = static_cast<LazyNode *>(n1);
+    LazyNode *l2 = static_cast<LazyNode *>(n2);
+    size_t temp = l1->getSize();
+    l1->setSize(l2->getSize());
+    l2->setSize(temp);
+}
+
+/**
+ * Allocates a LazyAVLNode holding the aggregate of just its own item.
+ */
+template <class Key, class Value, class Monoid>
+AVLNode<Key, Value> *LazyAVLTree<Key, Value, Monoid>::newNode(const Key &key, const Value &value,
+                                                              AVLNode<Key, Value> *parent)
+{
+    LazyNode *n = this->createNode(key, value, static_cast<LazyNode *>(parent));
+    n->setAggregate(Monoid::lift(key, value));
+    return n;
+}
+
+/**
+ * Copies the aggregate, size and pending tag along with the node for compact().
+ */
+template <class Key, class Value, class Monoid>
+AVLNode<Key, Value> *LazyAVLTree<Key, Value, Monoid>::copyNode(void *where, AVLNode<Key, Value> *from)
+{
+    LazyNode *f = static_cast<LazyNode *>(from);
+    LazyNode *n = new (where) LazyNode(f->getKey(), f->getValue(), nullptr);
+    n->setBalance(f->getBalance());
+    n->setAggregate(f->getAggregate());
+    n->setSize(f->getSize());
+    if (f->hasTag())
+    {
+        n->setTag(f->getTag());
+    }
+    return n;
+}
+
+/**
+ * Recomputes the aggregate and the subtree size of n from its children.
+ */
+template <class Key, class Value, class Monoid>
+void LazyAVLTree<Key, Value, Monoid>::refresh(AVLNode<Key, Value> *n)
+{
+    AugmentedAVLTree<Key, Value, Monoid>::refresh(n);
+    LazyNode *z = static_cast<LazyNode *>(n);
+    size_t size = 1;
+    if (z->getLeft() != nullptr)
+    {
+        size += z->getLeft()->getSize();
+    }
+    if (z->getRight() != nullptr)
+    {
+        size += z->getRight()->getSize();
+    }
+    z->setSize(size);
+}
+
+template <class Key, class Value, class Monoid>
+void LazyAVLTree<Key, Value, Monoid>::pushDown(AVLNode<Key, Value> *n)
+{
+    push(static_cast<LazyNode *>(n));
+}
+
+/**
+ * The descent hook of BinarySearchTree: pushes n's tag as a rotation does.
+ */
+template <class Key, class Value, class Monoid>
+void LazyAVLTree<Key, Value, Monoid>::pushPending(Node<Key, Value> *n) const
+{
+    push(static_cast<LazyNode *>(n));
+}
+
+/**
+ * Walks down to the highest node in [lo, hi] and then along the search
+ * paths of lo and hi, as aggregate() does. The nodes on those paths that lie
+ * in the range are updated directly and the whole subtrees hanging inside
+ * the range get the tag. Every node passed is pushed first, so the new tag
+ * lands after any older one, and refreshed afterwards, bottom up.
+ */
+template <class Key, class Value, class Monoid>
+void LazyAVLTree<Key, Value, Monoid>::applyRange(const Key &lo, const Key &hi, const RangeTag<Value> &tag)
+{
+    std::vector<LazyNode *> visited;
+    LazyNode *c = static_cast<LazyNode *>(this->root_);
+    while (c != nullptr && (c->getKey() < lo || hi < c->getKey()))
+    {
+        push(c);
+        visited.push_back(c);
+        c = (c->getKey() < lo) ? c->getRight() : c->getLeft();
+    }
+    if (c == nullptr)
+    {
+        return;
+    }
+    push(c);
+    visited.push_back(c);
+    applyValue(c, tag);
+
+    for (LazyNode *l = c->getLeft(); l != nullptr;)
+    {
+        push(l);
+        visited.push_back(l);
+        if (l->getKey() < lo)
+        {
+            l = l->getRight();
+        }
+        else
+        {
+            applyValue(l, tag);
+            applyTag(l->getRight(), tag);
+            l = l->getLeft();
+        }
+    }
+    for (LazyNode *r = c->getRight(); r != nullptr;)
+    {
+        push(r);
+        visited.push_back(r);
+        if (hi < r->getKey())
+        {
+            r = r->getLeft();
+        }
+        else
+        {
+            applyValue(r, tag);
+            applyTag(r->getLeft(), tag);
+            r = r->getRight();
+        }
+    }
+
+    // every visited node comes after its visited parent
+    for (size_t i = visited.size(); i > 0; --i)
+    {
+        refresh(visited[i - 1]);
+    }
+}
+
+/**
+ * Applies tag to the value stored in n only.
+ */
+template <class Key, class Value, class Monoid>
+void LazyAVLTree<Key, Value, Monoid>::applyValue(LazyNode *n, const RangeTag<Value> &tag)
+{
+    if (tag.assign)
+    {
+        n->setValue(tag.value);
+    }
+    n->setValue(n->getValue() + tag.add);
+}
+
+/**
+ * Applies tag to the whole subtree at n (if any): n's value and aggregate are
+ * updated now and the tag is composed with whatever n still owes its children.
+ */
+template <class Key, class Value, class Monoid>
+void LazyAVLTree<Key, Value, Monoid>::applyTag(LazyNode *n, const RangeTag<Value> &tag)
+{
+    if (n == nullptr)
+    {
+        return;
+    }
+    applyValue(n, tag);
+    Aggregate agg = n->getAggregate();
+    if (tag.assign)
+    {
+        agg = Monoid::assignAll(tag.value, n->getSize());
+    }
+    n->setAggregate(Monoid::addAll(agg, tag.add, n->getSize()));
+
+    RangeTag<Value> composed = tag;
+    if (!tag.assign && n->hasTag())
+    {
+        composed = n->getTag();
+        composed.add = composed.add + tag.add;
+    }
+    n->setTag(composed);
+}
+
+/**
+ * Hands the update pending at n (if any) down to its children.
+ */
+template <class Key, class Value, class Monoid>
+void LazyAVLTree<Key, Value, Monoid>::push(LazyNode *n)
+{
+    if (n == nullptr || !n->hasTag())
+    {
+        return;
+    }
+    applyTag(n->getLeft(), n->getTag());
+    applyTag(n->getRight(), n->getTag());
+    n->clearTag();
+}
+
+/**
+ * Follows the search path of key from the root, pushing every node on it.
+ * Returns the node holding key or NULL. Only tags move, so the tree's
+ * contents are logically unchanged and this is usable from const lookups.
+ */
+template <class Key, class Value, class Monoid>
+typename LazyAVLTree<Key, Value, Monoid>::LazyNode *LazyAVLTree<Key, Value, Monoid>::pushPath(const Key &key) const
+{
+    LazyNode *c = static_cast<LazyNode *>(this->root_);
+    while (c != nullptr)
+    {
+        push(c);
+        if (key < c->getKey())
+        {
+            c = c->getLeft();
+        }
+        else if (c->getKey() < key)
+        {
+            c = c->getRight();
+        }
+        else
+        {
+            break;
+        }
+    }
+    return c;
+}
+
+/*
+  ------------------------------------------------
+  End implementations for the LazyAVLTree class.
+  ------------------------------------------------
+*/
+
+#endif
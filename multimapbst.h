@@ -0,0 +1,149 @@
+#ifndef MULTIMAPBST_H
+#define MULTIMAPBST_H
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include "avlbst.h"
+
+/**
+ * Turns one of the pointer-based trees (BinarySearchTree, AVLTree,
+ * RedBlackTree, WAVLTree, SplayTree, ScapegoatTree, AugmentedAVLTree) into a
+ * multimap: insert() always adds a new item, and items with equal keys are
+ * kept in insertion order. A new item goes right of every equal key on its
+ * way down, so it lands just after them in key order, and rotations and
+ * rebuilds never reorder items. Use equal_range() or count() to reach all
+ * the values of a key; find() and operator[] return one of them, and
+ * erase() removes a single item.
+ *
+ * E.g. Multimap<int, Event> events; or Multimap<int, Event, RedBlackTree>.
+ */
+template <class Key, class Value, template <class, class> class Tree = AVLTree>
+class Multimap : public Tree<Key, Value>
+{
+public:
+    typedef typename BinarySearchTree<Key, Value>::iterator iterator;
+
+    virtual ~Multimap();
+
+    virtual void insert(const std::pair<const Key, Value> &new_item);
+    virtual void remove(const Key &key);
+    iterator erase(const iterator &pos);
+    iterator insert_near(const iterator &hint, const std::pair<const Key, Value> &new_item);
+
+protected:
+    virtual bool keysUnique() const;
+
+    // Helper functions
+    Node<Key, Value> *insertAfterEqual(const std::pair<const Key, Value> &new_item);
+};
+
+/*
+  ----------------------------------------------
+  Begin implementations for the Multimap class.
+  ----------------------------------------------
+*/
+
+/**
+ * Clears the tree here so that destroyNode still sees the full tree type.
+ */
+template <class Key, class Value, template <class, class> class Tree>
+Multimap<Key, Value, Tree>::~Multimap()
+{
+    this->clear();
+}
+
+/**
+ * Adds new_item after every item already stored under its key.
+ */
+template <class Key, class Value, template <class, class> class Tree>
+void Multimap<Key, Value, Tree>::insert(const std::pair<const Key, Value> &new_item)
+{
+    insertAfterEqual(new_item);
+}
+
+/**
+ * Removes every item with the given key: one descent to the first of them,
+ * then each is unlinked in turn, in O(log n + count * log n) for the
+ * rebalancing.
+ */
+template <class Key, class Value, template <class, class> class Tree>
+void Multimap<Key, Value, Tree>::remove(const Key &key)
+{
+    Node<Key, Value> *n = this->nodeAt(this->lower_bound(key));
+    while (n != nullptr && !(key < n->getKey()))
+    {
+        Node<Key, Value> *next = this->successor(n);
+        this->removeNode(n);
+        n = next;
+    }
+}
+
+/**
+ * Removes the single item pos points at, in O(log n), and returns an
+ * iterator to the item after it. The tree relinks nodes rather than moving
+ * items, so the other items with the same key keep their order and every
+ * other iterator stays valid.
+ */
+template <class Key, class Value, template <class, class> class Tree>
+typename Multimap<Key, Value, Tree>::iterator Multimap<Key, Value, Tree>::erase(const iterator &pos)
+{
+    Node<Key, Value> *n = this->nodeAt(pos);
+    Node<Key, Value> *next = this->successor(n);
+    this->removeNode(n);
+    return this->iteratorAt(next);
+}
+
+/**
+ * Inserts like insert() and returns an iterator to the new item. The hint
+ * is ignored: climbing from it could land the item among its equal keys
+ * rather than after them.
+ */
+template <class Key, class Value, template <class, class> class Tree>
+typename Multimap<Key, Value, Tree>::iterator
+Multimap<Key, Value, Tree>::insert_near(const iterator &hint, const std::pair<const Key, Value> &new_item)
+{
+    (void)hint;
+    return this->iteratorAt(insertAfterEqual(new_item));
+}
+
+/**
+ * Equal keys may sit on either side of each other after rotations.
+ */
+template <class Key, class Value, template <class, class> class Tree>
+bool Multimap<Key, Value, Tree>::keysUnique() const
+{
+    return false;
+}
+
+/**
+ * Never overwrites: equal keys send the search right, so the new node
+ * follows every node already holding its key. Returns the new node.
+ */
+template <class Key, class Value, template <class, class> class Tree>
+Node<Key, Value> *Multimap<Key, Value, Tree>::insertAfterEqual(const std::pair<const Key, Value> &new_item)
+{
+    Node<Key, Value> *parent = nullptr;
+    Node<Key, Value> *c = this->root_;
+    while (c != nullptr)
+    {
+        parent = c;
+        if (new_item.first < c->getKey())
+        {
+            c = c->getLeft();
+        }
+        else
+        {
+            c = c->getRight();
+        }
+    }
+    return this->attachLeaf(parent, new_item);
+}
+
+/*
+  --------------------------------------------
+  End implementations for the Multimap class.
+  --------------------------------------------
+*/
+
+#endif
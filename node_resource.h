@@ -0,0 +1,214 @@
+#ifndef NODE_RESOURCE_H
+#define NODE_RESOURCE_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define NODE_RESOURCE_HAS_PMR 1
+#endif
+#endif
+
+/**
+ * Where a tree gets the memory for its nodes from. This mirrors
+ * std::pmr::memory_resource so that the trees work the same way under C++11;
+ * PmrNodeResource adapts a real std::pmr resource when C++17 is available.
+ * A resource must outlive every tree that uses it.
+ */
+class NodeResource
+{
+public:
+    virtual ~NodeResource() {}
+
+    virtual void *allocate(size_t bytes, size_t align) = 0;
+    virtual void deallocate(void *p, size_t bytes, size_t align) = 0;
+
+    static NodeResource *newDelete();
+};
+
+/**
+ * The default resource, which uses the global operator new and delete.
+ */
+class NewDeleteNodeResource : public NodeResource
+{
+public:
+    virtual void *allocate(size_t bytes, size_t align);
+    virtual void deallocate(void *p, size_t bytes, size_t align);
+};
+
+/**
+ * Hands out memory from large chunks and only gives it back in bulk, when
+ * release() is called or the resource is destroyed; deallocate() is a no-op.
+ * Allocation is a pointer bump and the nodes of one tree end up packed
+ * together. If limit is nonzero, allocations that would take the total
+ * reserved from upstream past it throw std::bad_alloc, which caps the memory
+ * one owner (e.g. one tenant's maps) can use.
+ */
+class MonotonicNodeResource : public NodeResource
+{
+public:
+    MonotonicNodeResource(size_t chunkBytes = 64 * 1024, size_t limit = 0,
+                          NodeResource *upstream = NodeResource::newDelete());
+    virtual ~MonotonicNodeResource();
+
+    virtual void *allocate(size_t bytes, size_t align);
+    virtual void deallocate(void *p, size_t bytes, size_t align);
+
+    void release();
+    size_t bytesReserved() const;
+
+private:
+    MonotonicNodeResource(const MonotonicNodeResource &);
+    MonotonicNodeResource &operator=(const MonotonicNodeResource &);
+
+    struct Chunk
+    {
+        char *data;
+        size_t bytes;
+    };
+
+    NodeResource *upstream_;
+    size_t chunkBytes_;
+    size_t limit_;
+    size_t reserved_;
+    std::vector<Chunk> chunks_;
+    char *next_;
+    char *end_;
+};
+
+#ifdef NODE_RESOURCE_HAS_PMR
+/**
+ * Adapts a std::pmr::memory_resource (e.g. a monotonic_buffer_resource or an
+ * unsynchronized_pool_resource) so a tree can allocate its nodes from it.
+ */
+class PmrNodeResource : public NodeResource
+{
+public:
+    explicit PmrNodeResource(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        : resource_(resource)
+    {
+    }
+
+    virtual void *allocate(size_t bytes, size_t align)
+    {
+        return resource_->allocate(bytes, align);
+    }
+
+    virtual void deallocate(void *p, size_t bytes, size_t align)
+    {
+        resource_->deallocate(p, bytes, align);
+    }
+
+private:
+    std::pmr::memory_resource *resource_;
+};
+#endif
+
+/**
+ * Returns the shared new/delete resource used by trees built without one.
+ */
+inline NodeResource *NodeResource::newDelete()
+{
+    static NewDeleteNodeResource instance;
+    return &instance;
+}
+
+/**
+ * Node types are never over-aligned, so the alignment is only checked.
+ */
+inline void *NewDeleteNodeResource::allocate(size_t bytes, size_t align)
+{
+    (void)align;
+    return ::operator new(bytes);
+}
+
+inline void NewDeleteNodeResource::deallocate(void *p, size_t bytes, size_t align)
+{
+    (void)bytes;
+    (void)align;
+    ::operator delete(p);
+}
+
+/**
+ * Constructor taking the size of the chunks requested from upstream, the cap
+ * on the total reserved (0 for none) and the upstream resource.
+ */
+inline MonotonicNodeResource::MonotonicNodeResource(size_t chunkBytes, size_t limit, NodeResource *upstream)
+    : upstream_(upstream), chunkBytes_(chunkBytes), limit_(limit), reserved_(0), next_(NULL), end_(NULL)
+{
+}
+
+/**
+ * Returns every chunk to upstream.
+ */
+inline MonotonicNodeResource::~MonotonicNodeResource()
+{
+    release();
+}
+
+/**
+ * Bumps a pointer in the current chunk, starting a new chunk (at least large
+ * enough for the request) when it does not fit.
+ */
+inline void *MonotonicNodeResource::allocate(size_t bytes, size_t align)
+{
+    size_t pad = (align - (size_t)next_ % align) % align;
+    if (next_ == NULL || (size_t)(end_ - next_) < pad + bytes)
+    {
+        size_t size = (bytes + align > chunkBytes_) ? bytes + align : chunkBytes_;
+        if (limit_ != 0 && reserved_ + size > limit_)
+        {
+            throw std::bad_alloc();
+        }
+        Chunk c;
+        c.data = static_cast<char *>(upstream_->allocate(size, alignof(std::max_align_t)));
+        c.bytes = size;
+        chunks_.push_back(c);
+        reserved_ += size;
+        next_ = c.data;
+        end_ = c.data + size;
+        pad = (align - (size_t)next_ % align) % align;
+    }
+    void *p = next_ + pad;
+    next_ += pad + bytes;
+    return p;
+}
+
+/**
+ * Does nothing: memory is only reclaimed by release().
+ */
+inline void MonotonicNodeResource::deallocate(void *p, size_t bytes, size_t align)
+{
+    (void)p;
+    (void)bytes;
+    (void)align;
+}
+
+/**
+ * Returns all chunks to upstream at once. Any tree still using this resource
+ * must be cleared (or destroyed) first.
+ */
+inline void MonotonicNodeResource::release()
+{
+    for (size_t i = 0; i < chunks_.size(); ++i)
+    {
+        upstream_->deallocate(chunks_[i].data, chunks_[i].bytes, alignof(std::max_align_t));
+    }
+    chunks_.clear();
+    reserved_ = 0;
+    next_ = NULL;
+    end_ = NULL;
+}
+
+/**
+ * Returns the total size of the chunks currently held from upstream.
+ */
+inline size_t MonotonicNodeResource::bytesReserved() const
+{
+    return reserved_;
+}
+
+#endif
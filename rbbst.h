@@ -0,0 +1,495 @@
+#ifndef RBBST_H
+#define RBBST_H
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <cstdint>
+#include <algorithm>
+#include "bst.h"
+
+/**
+ * The two colors a node of a red-black tree can take.
+ */
+enum Color
+{
+    red,
+    black
+};
+
+/**
+ * A special kind of node for a red-black tree, which adds the color as a data member.
+ */
+template <typename Key, typename Value>
+class RBNode : public Node<Key, Value>
+{
+public:
+    // Constructor/destructor.
+    RBNode(const Key &key, const Value &value, RBNode<Key, Value> *parent);
+    virtual ~RBNode();
+
+    // Getter/setter for the node's color.
+    Color getColor() const;
+    void setColor(Color c);
+
+    // Getters for parent, left, and right. These need to be redefined since they
+    // return pointers to RBNodes - not plain Nodes. See the Node class in bst.h
+    // for more information.
+    virtual RBNode<Key, Value> *getParent() const override;
+    virtual RBNode<Key, Value> *getLeft() const override;
+    virtual RBNode<Key, Value> *getRight() const override;
+
+protected:
+    Color color_;
+};
+
+/*
+  -------------------------------------------------
+  Begin implementations for the RBNode class.
+  -------------------------------------------------
+*/
+
+/**
+ * An explicit constructor to initialize the elements by calling the base class constructor and setting
+ * the color to red since every new node will be red when it is first inserted.
+ */
+template <class Key, class Value>
+RBNode<Key, Value>::RBNode(const Key &key, const Value &value, RBNode<Key, Value> *parent) : Node<Key, Value>(key, value, parent), color_(red)
+{
+}
+
+/**
+ * A destructor which does nothing.
+ */
+template <class Key, class Value>
+RBNode<Key, Value>::~RBNode()
+{
+}
+
+/**
+ * A getter for the color of a RBNode.
+ */
+template <class Key, class Value>
+Color RBNode<Key, Value>::getColor() const
+{
+    return color_;
+}
+
+/**
+ * A setter for the color of a RBNode.
+ */
+template <class Key, class Value>
+void RBNode<Key, Value>::setColor(Color c)
+{
+    color_ = c;
+}
+
+/**
+ * An overridden function for getting the parent since a static_cast is necessary to make sure
+ * that our node is a RBNode.
+ */
+template <class Key, class Value>
+RBNode<Key, Value> *RBNode<Key, Value>::getParent() const
+{
+    return static_cast<RBNode<Key, Value> *>(this->parent_);
+}
+
+/**
+ * Overridden for the same reasons as above.
+ */
+template <class Key, class Value>
+RBNode<Key, Value> *RBNode<Key, Value>::getLeft() const
+{
+    return static_cast<RBNode<Key, Value> *>(this->left_);
+}
+
+/**
+ * Overridden for the same reasons as above.
+ */
+template <class Key, class Value>
+RBNode<Key, Value> *RBNode<Key, Value>::getRight() const
+{
+    return static_cast<RBNode<Key, Value> *>(this->right_);
+}
+
+/*
+  -----------------------------------------------
+  End implementations for the RBNode class.
+  -----------------------------------------------
+*/
+
+/**
+ * A red-black tree. Every update does at most two rotations on insert and
+ * three on remove; the rest of the rebalancing is recoloring, which (unlike
+ * AVLTree::removeFix) touches only the nodes on the path and is O(1) amortized.
+ */
+template <class Key, class Value>
+class RedBlackTree : public BinarySearchTree<Key, Value>
+{
+public:
+    virtual void insert(const std::pair<const Key, Value> &new_item);
+
+protected:
+    virtual void nodeSwap(RBNode<Key, Value> *n1, RBNode<Key, Value> *n2);
+    virtual void removeNode(Node<Key, Value> *node);
+    virtual bool relinkable() const;
+    virtual Node<Key, Value> *attachLeaf(Node<Key, Value> *parent, const std::pair<const Key, Value> &new_item);
+
+    // Helper functions
+    static bool isRed(RBNode<Key, Value> *n);
+    void insertFix(RBNode<Key, Value> *n);
+    void removeFix(RBNode<Key, Value> *x, RBNode<Key, Value> *p);
+    void rotateLeft(RBNode<Key, Value> *n);
+    void rotateRight(RBNode<Key, Value> *n);
+};
+
+/*
+  --------------------------------------------------
+  Begin implementations for the RedBlackTree class.
+  --------------------------------------------------
+*/
+
+/**
+ * Missing (NULL) children count as black.
+ */
+template <class Key, class Value>
+bool RedBlackTree<Key, Value>::isRed(RBNode<Key, Value> *n)
+{
+    return n != nullptr && n->getColor() == red;
+}
+
+/*
+ * If key is already in the tree, the current value is overwritten with the
+ * updated value and no rebalancing is needed.
+ */
+template <class Key, class Value>
+void RedBlackTree<Key, Value>::insert(const std::pair<const Key, Value> &new_item)
+{
+    RBNode<Key, Value> *parent = nullptr;
+    RBNode<Key, Value> *c = static_cast<RBNode<Key, Value> *>(this->root_);
+
+    // walking down to the insertion point
+    while (c != nullptr)
+    {
+        parent = c;
+        if (new_item.first < c->getKey())
+        {
+            c = c->getLeft();
+        }
+        else if (new_item.first > c->getKey())
+        {
+            c = c->getRight();
+        }
+        else
+        {
+            c->setValue(new_item.second);
+            return;
+        }
+    }
+
+    attachLeaf(parent, new_item);
+}
+
+/**
+ * Links a new red node under parent and restores the red-black properties.
+ */
+template <class Key, class Value>
+Node<Key, Value> *RedBlackTree<Key, Value>::attachLeaf(Node<Key, Value> *parent,
+                                                       const std::pair<const Key, Value> &new_item)
+{
+    RBNode<Key, Value> *p = static_cast<RBNode<Key, Value> *>(parent);
+    RBNode<Key, Value> *n = this->createNode(new_item.first, new_item.second, p);
+    if (p == nullptr)
+    {
+        this->root_ = n;
+    }
+    else if (new_item.first < p->getKey())
+    {
+        p->setLeft(n);
+    }
+    else
+    {
+        p->setRight(n);
+    }
+    this->noteLinked(n);
+    insertFix(n);
+    return n;
+}
+
+/**
+ * Restores the red-black properties after inserting the red node n.
+ */
+template <class Key, class Value>
+void RedBlackTree<Key, Value>::insertFix(RBNode<Key, Value> *n)
+{
+    while (isRed(n->getParent()))
+    {
+        RBNode<Key, Value> *p = n->getParent();
+        // a red parent is never the root, so the grandparent exists
+        RBNode<Key, Value> *g = p->getParent();
+        if (g->getLeft() == p)
+        {
+            RBNode<Key, Value> *u = g->getRight();
+            // red uncle: recolor and continue from the grandparent
+            if (isRed(u))
+            {
+                p->setColor(black);
+                u->setColor(black);
+                g->setColor(red);
+                n = g;
+                continue;
+            }
+            // zig-zag: rotate into the zig-zig shape first
+            if (p->getRight() == n)
+            {
+                rotateLeft(p);
+                n = p;
+                p = n->getParent();
+            }
+            rotateRight(g);
+            p->setColor(black);
+            g->setColor(red);
+            break;
+        }
+        else
+        {
+            RBNode<Key, Value> *u = g->getLeft();
+            if (isRed(u))
+            {
+                p->setColor(black);
+                u->setColor(black);
+                g->setColor(red);
+                n = g;
+                continue;
+            }
+            if (p->getLeft() == n)
+            {
+                rotateRight(p);
+                n = p;
+                p = n->getParent();
+            }
+            rotateLeft(g);
+            p->setColor(black);
+            g->setColor(red);
+            break;
+        }
+    }
+    static_cast<RBNode<Key, Value> *>(this->root_)->setColor(black);
+}
+
+/*
+ * As in the other trees, a node with 2 children is swapped with its
+ * predecessor first so that the node actually unlinked has at most one child.
+ */
+template <class Key, class Value>
+void RedBlackTree<Key, Value>::removeNode(Node<Key, Value> *node)
+{
+    RBNode<Key, Value> *n = static_cast<RBNode<Key, Value> *>(node);
+    if (n->getLeft() != nullptr && n->getRight() != nullptr)
+    {
+        nodeSwap(n, static_cast<RBNode<Key, Value> *>(this->predecessor(n)));
+    }
+
+    RBNode<Key, Value> *child = (n->getLeft() != nullptr) ? n->getLeft() : n->getRight();
+    RBNode<Key, Value> *p = n->getParent();
+
+    // splicing n out
+    this->noteUnlinking(n);
+    if (p == nullptr)
+    {
+        this->root_ = child;
+    }
+    else if (p->getLeft() == n)
+    {
+        p->setLeft(child);
+    }
+    else
+    {
+        p->setRight(child);
+    }
+    if (child != nullptr)
+    {
+        child->setParent(p);
+    }
+
+    // removing a red node never changes a black height; otherwise the
+    // replacing child carries an extra black that removeFix pushes up
+    if (n->getColor() == black)
+    {
+        removeFix(child, p);
+    }
+    this->destroyNode(n);
+}
+
+/**
+ * Removes the extra black on x (which may be NULL), whose parent is p.
+ */
+template <class Key, class Value>
+void RedBlackTree<Key, Value>::removeFix(RBNode<Key, Value> *x, RBNode<Key, Value> *p)
+{
+    while (x != this->root_ && !isRed(x))
+    {
+        if (p->getLeft() == x)
+        {
+            // x carries a double black, so its sibling exists
+            RBNode<Key, Value> *s = p->getRight();
+            if (isRed(s))
+            {
+                s->setColor(black);
+                p->setColor(red);
+                rotateLeft(p);
+                s = p->getRight();
+            }
+            if (!isRed(s->getLeft()) && !isRed(s->getRight()))
+            {
+                s->setColor(red);
+                x = p;
+                p = x->getParent();
+            }
+            else
+            {
+                if (!isRed(s->getRight()))
+                {
+                    s->getLeft()->setColor(black);
+                    s->setColor(red);
+                    rotateRight(s);
+                    s = p->getRight();
+                }
+                s->setColor(p->getColor());
+                p->setColor(black);
+                s->getRight()->setColor(black);
+                rotateLeft(p);
+                x = static_cast<RBNode<Key, Value> *>(this->root_);
+            }
+        }
+        else
+        {
+            RBNode<Key, Value> *s = p->getLeft();
+            if (isRed(s))
+            {
+                s->setColor(black);
+                p->setColor(red);
+                rotateRight(p);
+                s = p->getLeft();
+            }
+            if (!isRed(s->getLeft()) && !isRed(s->getRight()))
+            {
+                s->setColor(red);
+                x = p;
+                p = x->getParent();
+            }
+            else
+            {
+                if (!isRed(s->getLeft()))
+                {
+                    s->getRight()->setColor(black);
+                    s->setColor(red);
+                    rotateLeft(s);
+                    s = p->getLeft();
+                }
+                s->setColor(p->getColor());
+                p->setColor(black);
+                s->getLeft()->setColor(black);
+                rotateRight(p);
+                x = static_cast<RBNode<Key, Value> *>(this->root_);
+            }
+        }
+    }
+    if (x != nullptr)
+    {
+        x->setColor(black);
+    }
+}
+
+/**
+ * Swaps the positions of two nodes and their colors, so that the colors stay
+ * attached to the positions in the tree.
+ */
+template <class Key, class Value>
+void RedBlackTree<Key, Value>::nodeSwap(RBNode<Key, Value> *n1, RBNode<Key, Value> *n2)
+{
+    BinarySearchTree<Key, Value>::nodeSwap(n1, n2);
+    Color tempC = n1->getColor();
+    n1->setColor(n2->getColor());
+    n2->setColor(tempC);
+}
+
+template <class Key, class Value>
+void RedBlackTree<Key, Value>::rotateLeft(RBNode<Key, Value> *n)
+{
+    RBNode<Key, Value> *r = n->getRight();
+    RBNode<Key, Value> *p = n->getParent();
+
+    // rotation
+    n->setRight(r->getLeft());
+    if (r->getLeft() != nullptr)
+    {
+        r->getLeft()->setParent(n);
+    }
+
+    // changing pointers
+    if (p == nullptr)
+    {
+        this->root_ = r;
+    }
+    else if (p->getLeft() == n)
+    {
+        p->setLeft(r);
+    }
+    else
+    {
+        p->setRight(r);
+    }
+    r->setParent(p);
+    r->setLeft(n);
+    n->setParent(r);
+}
+
+template <class Key, class Value>
+void RedBlackTree<Key, Value>::rotateRight(RBNode<Key, Value> *n)
+{
+    RBNode<Key, Value> *l = n->getLeft();
+    RBNode<Key, Value> *p = n->getParent();
+
+    // rotation
+    n->setLeft(l->getRight());
+    if (l->getRight() != nullptr)
+    {
+        l->getRight()->setParent(n);
+    }
+
+    // changing pointers
+    if (p == nullptr)
+    {
+        this->root_ = l;
+    }
+    else if (p->getLeft() == n)
+    {
+        p->setLeft(l);
+    }
+    else
+    {
+        p->setRight(l);
+    }
+    l->setParent(p);
+    l->setRight(n);
+    n->setParent(l);
+}
+
+/**
+ * A DSW rebuild would leave the colors in the nodes stale, and the tree keeps
+ * itself balanced anyway, so rebalance() and setAutoRebalance() refuse.
+ */
+template <class Key, class Value>
+bool RedBlackTree<Key, Value>::relinkable() const
+{
+    return false;
+}
+
+/*
+  ------------------------------------------------
+  End implementations for the RedBlackTree class.
+  ------------------------------------------------
+*/
+
+#endif
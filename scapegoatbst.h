@@ -0,0 +1,183 @@
+#ifndef SCAPEGOATBST_H
+#define SCAPEGOATBST_H
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <cmath>
+#include <stdexcept>
+#include "bst.h"
+
+/**
+ * A scapegoat tree (Galperin and Rivest). Nodes carry no balance information
+ * at all, so the tree uses the plain Node class and is the smallest per entry
+ * of the balanced variants. Instead, an insert that lands deeper than
+ * log_{1/alpha}(n) walks back up to the first ancestor whose subtree is
+ * alpha-weight-unbalanced (the scapegoat) and rebuilds that subtree into a
+ * complete tree in linear time with the base class's rebalanceSubtree(); the
+ * whole tree is rebuilt once removes have shrunk it below alpha times its
+ * size at the last full rebuild. Updates are O(log n) amortized and lookups
+ * are O(log n) worst case.
+ */
+template <class Key, class Value>
+class ScapegoatTree : public BinarySearchTree<Key, Value>
+{
+public:
+    ScapegoatTree(double alpha = 2.0 / 3.0);
+    virtual void insert(const std::pair<const Key, Value> &new_item);
+    virtual void clear();
+
+    size_t size() const;
+    unsigned long getRebuilds() const;
+
+protected:
+    virtual Node<Key, Value> *attachLeaf(Node<Key, Value> *parent, const std::pair<const Key, Value> &new_item);
+    virtual void removeNode(Node<Key, Value> *n);
+
+    // Helper functions
+    size_t depthLimit() const;
+
+    double alpha_;
+    size_t size_;
+    size_t maxSize_;
+    unsigned long rebuilds_;
+};
+
+/*
+  --------------------------------------------------
+  Begin implementations for the ScapegoatTree class.
+  --------------------------------------------------
+*/
+
+/**
+ * Constructor taking the weight-balance factor alpha, which must lie in
+ * (0.5, 1). Smaller values keep the tree shallower at the cost of more
+ * frequent rebuilds.
+ */
+template <class Key, class Value>
+ScapegoatTree<Key, Value>::ScapegoatTree(double alpha) : alpha_(alpha), size_(0), maxSize_(0), rebuilds_(0)
+{
+    if (alpha_ <= 0.5 || alpha_ >= 1.0)
+    {
+        throw std::invalid_argument("alpha must be in (0.5, 1)");
+    }
+}
+
+/**
+ * Returns the number of items in the tree.
+ */
+template <class Key, class Value>
+size_t ScapegoatTree<Key, Value>::size() const
+{
+    return size_;
+}
+
+/**
+ * Returns how many subtree (or whole tree) rebuilds have happened so far.
+ */
+template <class Key, class Value>
+unsigned long ScapegoatTree<Key, Value>::getRebuilds() const
+{
+    return rebuilds_;
+}
+
+/**
+ * Removes all contents and resets the size bookkeeping.
+ */
+template <class Key, class Value>
+void ScapegoatTree<Key, Value>::clear()
+{
+    BinarySearchTree<Key, Value>::clear();
+    size_ = 0;
+    maxSize_ = 0;
+}
+
+/**
+ * The deepest an insert may land before a rebuild is needed:
+ * floor(log_{1/alpha}(size)).
+ */
+template <class Key, class Value>
+size_t ScapegoatTree<Key, Value>::depthLimit() const
+{
+    return (size_t)std::floor(std::log((double)size_) / std::log(1.0 / alpha_));
+}
+
+/*
+ * If key is already in the tree, the current value is overwritten with the
+ * updated value.
+ */
+template <class Key, class Value>
+void ScapegoatTree<Key, Value>::insert(const std::pair<const Key, Value> &new_item)
+{
+    Node<Key, Value> *parent = nullptr;
+    Node<Key, Value> *c = this->root_;
+
+    // walking down to the insertion point
+    while (c != nullptr)
+    {
+        parent = c;
+        if (new_item.first < c->getKey())
+        {
+            c = c->getLeft();
+        }
+        else if (new_item.first > c->getKey())
+        {
+            c = c->getRight();
+        }
+        else
+        {
+            c->setValue(new_item.second);
+            return;
+        }
+    }
+
+    attachLeaf(parent, new_item);
+}
+
+/**
+ * Links a new node under parent. If that leaves it deeper than depthLimit(),
+ * rebalanceIfDeep() walks back up to the scapegoat and rebuilds its subtree.
+ */
+template <class Key, class Value>
+Node<Key, Value> *ScapegoatTree<Key, Value>::attachLeaf(Node<Key, Value> *parent,
+                                                        const std::pair<const Key, Value> &new_item)
+{
+    Node<Key, Value> *n = BinarySearchTree<Key, Value>::attachLeaf(parent, new_item);
+    ++size_;
+    maxSize_ = std::max(maxSize_, size_);
+
+    if (this->rebalanceIfDeep(n, (double)depthLimit(), alpha_))
+    {
+        ++rebuilds_;
+    }
+    return n;
+}
+
+/*
+ * Removes as in the plain BinarySearchTree and rebuilds the whole tree once
+ * it has shrunk below alpha times its size at the last full rebuild.
+ */
+template <class Key, class Value>
+void ScapegoatTree<Key, Value>::removeNode(Node<Key, Value> *n)
+{
+    BinarySearchTree<Key, Value>::removeNode(n);
+    --size_;
+
+    if ((double)size_ < alpha_ * (double)maxSize_)
+    {
+        if (this->root_ != nullptr)
+        {
+            this->rebalanceSubtree(this->root_);
+            ++rebuilds_;
+        }
+        maxSize_ = size_;
+    }
+}
+
+/*
+  ------------------------------------------------
+  End implementations for the ScapegoatTree class.
+  ------------------------------------------------
+*/
+
+#endif
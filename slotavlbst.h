@@ -0,0 +1,1328 @@
+#ifndef SLOTAVLBST_H
+#define SLOTAVLBST_H
+
+#include <iostream>
+#include <exception>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <cstddef>
+#include <cstdlib>
+#include <cstdint>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * One node of a SlotAVLTree. The item is constructed in place only while the
+ * slot is in use; a free slot keeps the next free one in parent.
+ */
+template <class Item, class Index>
+struct AVLSlot
+{
+    typename std::aligned_storage<sizeof(Item), alignof(Item)>::type item;
+    Index parent;
+    Index left;
+    Index right;
+    int8_t balance;
+};
+
+/**
+ * Slot storage that grows by blocks from the heap as the tree needs them.
+ * The first blocks hold 16, 16, 32, ... 512 slots, each doubling the
+ * capacity so that a small tree stays small, and every block after those
+ * holds 1024. Blocks are only released by clear(), so slots never move.
+ * Used by IndexedAVLTree.
+ */
+template <class Item, class Index>
+class BlockSlots
+{
+public:
+    typedef AVLSlot<Item, Index> Slot;
+    typedef Index index_type;
+
+    BlockSlots();
+    ~BlockSlots();
+    Slot &operator[](Index i) const;
+    void grow(Index used);
+    void release();
+    size_t capacity() const;
+    static size_t limit();
+
+private:
+    static const unsigned FIRST_BITS = 4;
+    static const size_t FIRST_SIZE = (size_t)1 << FIRST_BITS;
+    static const unsigned BLOCK_BITS = 10;
+    static const size_t BLOCK_SIZE = (size_t)1 << BLOCK_BITS;
+    // the growing blocks that together cover the first BLOCK_SIZE slots
+    static const size_t SMALL_BLOCKS = BLOCK_BITS - FIRST_BITS + 1;
+
+    BlockSlots(const BlockSlots &);
+    BlockSlots &operator=(const BlockSlots &);
+
+    std::vector<Slot *> blocks_;
+    size_t capacity_;
+};
+
+/**
+ * Slot storage for at most N slots in an array inside the tree object, left
+ * uninitialized until handed out. Used by StaticAVLTree.
+ */
+template <class Item, class Index, size_t N>
+class InlineSlots
+{
+public:
+    typedef AVLSlot<Item, Index> Slot;
+    typedef Index index_type;
+
+    InlineSlots() {}
+    Slot &operator[](Index i) const { return slots_[i]; }
+    void grow(Index) {}
+    void release() {}
+    static constexpr size_t capacity() { return N; }
+    static size_t limit() { return N; }
+
+private:
+    InlineSlots(const InlineSlots &);
+    InlineSlots &operator=(const InlineSlots &);
+
+    // mutable so that const lookups can hand out iterators to mutable items,
+    // as the pointer-based trees do
+    mutable Slot slots_[N];
+};
+
+/**
+ * The AVL tree behind IndexedAVLTree and StaticAVLTree: nodes are slots of
+ * a Slots storage (BlockSlots or InlineSlots) and link to each other with
+ * slot indices of Slots::index_type rather than pointers, and removed slots
+ * are reused through a free list threaded through their parent links. The
+ * largest index value is the missing link, so a tree holds at most
+ * Slots::limit() items, fewer than that.
+ *
+ * The interface, iterator semantics and balancing match AVLTree: items never
+ * move once inserted, so iterators and references to other items stay valid
+ * across inserts and removes.
+ */
+template <class Key, class Value, class Slots>
+class SlotAVLTree
+{
+public:
+    typedef typename Slots::index_type Index;
+
+    SlotAVLTree();
+    SlotAVLTree(const SlotAVLTree &other);
+    SlotAVLTree &operator=(const SlotAVLTree &other);
+    ~SlotAVLTree();
+    void insert(const std::pair<const Key, Value> &keyValuePair);
+    void remove(const Key &key);
+    void pop_min();
+    void pop_max();
+    void clear();
+    bool isBalanced() const;
+    void print() const;
+    bool empty() const;
+    size_t size() const;
+    size_t capacity() const;
+    static size_t slotBytes();
+
+    /**
+     * A bidirectional iterator over the items in key order.
+     */
+    class iterator
+    {
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef std::pair<const Key, Value> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef std::pair<const Key, Value> *pointer;
+        typedef std::pair<const Key, Value> &reference;
+
+        iterator();
+
+        std::pair<const Key, Value> &operator*() const;
+        std::pair<const Key, Value> *operator->() const;
+
+        bool operator==(const iterator &rhs) const;
+        bool operator!=(const iterator &rhs) const;
+
+        iterator &operator++();
+        iterator operator++(int);
+        iterator &operator--();
+        iterator operator--(int);
+
+    protected:
+        friend class SlotAVLTree<Key, Value, Slots>;
+        iterator(const SlotAVLTree<Key, Value, Slots> *tree, Index index);
+        const SlotAVLTree<Key, Value, Slots> *tree_;
+        Index current_;
+    };
+
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+
+    iterator begin() const;
+    iterator end() const;
+    reverse_iterator rbegin() const;
+    reverse_iterator rend() const;
+    iterator find(const Key &key) const;
+    iterator find_from(const iterator &hint, const Key &key) const;
+    iterator lower_bound(const Key &key) const;
+    iterator upper_bound(const Key &key) const;
+    std::pair<iterator, iterator> equal_range(const Key &key) const;
+    size_t count(const Key &key) const;
+    template <typename Update, typename Make>
+    iterator upsert(const Key &key, Update fnIfPresent, Make makeIfAbsent);
+    template <typename Update>
+    bool modify(const Key &key, Update fn);
+    Value &operator[](const Key &key);
+    Value const &operator[](const Key &key) const;
+
+protected:
+    typedef std::pair<const Key, Value> Item;
+    typedef typename Slots::Slot Slot;
+
+    // Missing links hold NIL.
+    static const Index NIL = (Index)~(Index)0;
+
+    // Slot access and allocation
+    Slot &slot(Index i) const;
+    Item &item(Index i) const;
+    const Key &key(Index i) const;
+    Index allocateSlot(const Item &keyValuePair, Index parent);
+    void freeSlot(Index i);
+    void copyFrom(const SlotAVLTree &other);
+
+    // Helper functions
+    Index internalFind(const Key &key) const;
+    Index successor(Index i) const;
+    Index predecessor(Index i) const;
+    Index extreme(bool leftmost) const;
+    Index fingerStart(Index hint, const Key &key) const;
+    Index attachLeaf(Index parent, const Item &keyValuePair);
+    void removeSlot(Index n);
+    void replaceChild(Index parent, Index oldChild, Index newChild);
+    void nodeSwap(Index n1, Index n2);
+    void rotateLeft(Index n);
+    void rotateRight(Index n);
+    Index rebalance(Index n);
+    int calculateHeight(Index n) const;
+
+    Slots slots_;
+    Index root_;
+    Index freeList_;
+    Index used_; // slots handed out so far (live or free)
+    Index size_;
+};
+
+/*
+-----------------------------------------------
+Begin implementations for the BlockSlots class.
+-----------------------------------------------
+*/
+
+template <class Item, class Index>
+BlockSlots<Item, Index>::BlockSlots() : capacity_(0)
+{
+}
+
+template <class Item, class Index>
+BlockSlots<Item, Index>::~BlockSlots()
+{
+    release();
+}
+
+/**
+ * Returns the slot with index i. Below BLOCK_SIZE, block b > 0 starts at
+ * index 2^(b + FIRST_BITS - 1), so the highest set bit of i picks it.
+ */
+template <class Item, class Index>
+typename BlockSlots<Item, Index>::Slot &BlockSlots<Item, Index>::operator[](Index i) const
+{
+    if (i >= BLOCK_SIZE)
+    {
+        return blocks_[(i >> BLOCK_BITS) + SMALL_BLOCKS - 1][i & (BLOCK_SIZE - 1)];
+    }
+    if (i < FIRST_SIZE)
+    {
+        return blocks_[0][i];
+    }
+    unsigned msb = 31 - (unsigned)__builtin_clz((unsigned)i);
+    return blocks_[msb - FIRST_BITS + 1][i - ((Index)1 << msb)];
+}
+
+/**
+ * Makes slot used available, adding a block when it is the first of one.
+ * Slots are handed out in index order, so used is never past the end.
+ */
+template <class Item, class Index>
+void BlockSlots<Item, Index>::grow(Index used)
+{
+    if (used == capacity_)
+    {
+        size_t size = (used < FIRST_SIZE) ? (size_t)FIRST_SIZE : std::min((size_t)used, (size_t)BLOCK_SIZE);
+        blocks_.push_back(new Slot[size]);
+        capacity_ += size;
+    }
+}
+
+/**
+ * Frees all blocks. The tree destroys the items in them first.
+ */
+template <class Item, class Index>
+void BlockSlots<Item, Index>::release()
+{
+    for (size_t b = 0; b < blocks_.size(); ++b)
+    {
+        delete[] blocks_[b];
+    }
+    blocks_.clear();
+    capacity_ = 0;
+}
+
+/**
+ * Returns the number of slots in the blocks allocated so far.
+ */
+template <class Item, class Index>
+size_t BlockSlots<Item, Index>::capacity() const
+{
+    return capacity_;
+}
+
+/**
+ * Returns how many slots can be indexed; the last index value is the NIL link.
+ */
+template <class Item, class Index>
+size_t BlockSlots<Item, Index>::limit()
+{
+    return (size_t)(Index)~(Index)0;
+}
+
+/*
+---------------------------------------------
+End implementations for the BlockSlots class.
+---------------------------------------------
+*/
+
+/*
+------------------------------------------------------------
+Begin implementations for the SlotAVLTree::iterator class.
+------------------------------------------------------------
+*/
+
+template <class Key, class Value, class Slots>
+SlotAVLTree<Key, Value, Slots>::iterator::iterator() : tree_(NULL), current_(NIL)
+{
+}
+
+template <class Key, class Value, class Slots>
+SlotAVLTree<Key, Value, Slots>::iterator::iterator(const SlotAVLTree<Key, Value, Slots> *tree, Index index)
+    : tree_(tree), current_(index)
+{
+}
+
+/**
+ * Provides access to the item.
+ */
+template <class Key, class Value, class Slots>
+std::pair<const Key, Value> &SlotAVLTree<Key, Value, Slots>::iterator::operator*() const
+{
+    return tree_->item(current_);
+}
+
+/**
+ * Provides access to the address of the item.
+ */
+template <class Key, class Value, class Slots>
+std::pair<const Key, Value> *SlotAVLTree<Key, Value, Slots>::iterator::operator->() const
+{
+    return &(tree_->item(current_));
+}
+
+/**
+ * Iterators are equal when they refer to the same slot; every end() compares
+ * equal regardless of tree.
+ */
+template <class Key, class Value, class Slots>
+bool SlotAVLTree<Key, Value, Slots>::iterator::operator==(const iterator &rhs) const
+{
+    return current_ == rhs.current_ && (current_ == NIL || tree_ == rhs.tree_);
+}
+
+template <class Key, class Value, class Slots>
+bool SlotAVLTree<Key, Value, Slots>::iterator::operator!=(const iterator &rhs) const
+{
+    return !(*this == rhs);
+}
+
+/**
+ * Advances the iterator's location using an in-order sequencing
+ */
+template <class Key, class Value, class Slots>
+typename SlotAVLTree<Key, Value, Slots>::iterator &SlotAVLTree<Key, Value, Slots>::iterator::operator++()
+{
+    current_ = tree_->successor(current_);
+    return *this;
+}
+
+template <class Key, class Value, class Slots>
+typename SlotAVLTree<Key, Value, Slots>::iterator SlotAVLTree<Key, Value, Slots>::iterator::operator++(int)
+{
+    iterator before = *this;
+    ++*this;
+    return before;
+}
+
+/**
+ * Moves back one item; from end() it moves to the largest item.
+ */
+template <class Key, class Value, class Slots>
+typename SlotAVLTree<Key, Value, Slots>::iterator &SlotAVLTree<Key, Value, Slots>::iterator::operator--()
+{
+    current_ = (current_ == NIL) ? tree_->extreme(false) : tree_->predecessor(current_);
+    return *this;
+}
+
+template <class Key, class Value, class Slots>
+typename SlotAVLTree<Key, Value, Slots>::iterator SlotAVLTree<Key, Value, Slots>::iterator::operator--(int)
+{
+    iterator before = *this;
+    --*this;
+    return before;
+}
+
+/*
+----------------------------------------------------------
+End implementations for the SlotAVLTree::iterator class.
+----------------------------------------------------------
+*/
+
+/*
+--------------------------------------------------
+Begin implementations for the SlotAVLTree class.
+--------------------------------------------------
+*/
+
+/**
+ * Starts empty. No slot is touched until it is handed out.
+ */
+template <class Key, class Value, class Slots>
+SlotAVLTree<Key, Value, Slots>::SlotAVLTree() : root_(NIL), freeList_(NIL), used_(0), size_(0)
+{
+}
+
+/**
+ * Copies every item into the same slot it has in other, so the copy has the
+ * same shape and free list.
+ */
+template <class Key, class Value, class Slots>
+SlotAVLTree<Key, Value, Slots>::SlotAVLTree(const SlotAVLTree &other)
+    : root_(NIL), freeList_(NIL), used_(0), size_(0)
+{
+    copyFrom(other);
+}
+
+template <class Key, class Value, class Slots>
+SlotAVLTree<Key, Value, Slots> &SlotAVLTree<Key, Value, Slots>::operator=(const SlotAVLTree &other)
+{
+    if (this != &other)
+    {
+        clear();
+        copyFrom(other);
+    }
+    return *this;
+}
+
+template <class Key, class Value, class Slots>
+SlotAVLTree<Key, Value, Slots>::~SlotAVLTree()
+{
+    clear();
+}
+
+/**
+ * Returns the slot with index i.
+ */
+template <class Key, class Value, class Slots>
+typename SlotAVLTree<Key, Value, Slots>::Slot &SlotAVLTree<Key, Value, Slots>::slot(Index i) const
+{
+    return slots_[i];
+}
+
+template <class Key, class Value, class Slots>
+typename SlotAVLTree<Key, Value, Slots>::Item &SlotAVLTree<Key, Value, Slots>::item(Index i) const
+{
+    return *reinterpret_cast<Item *>(&slot(i).item);
+}
+
+template <class Key, class Value, class Slots>
+const Key &SlotAVLTree<Key, Value, Slots>::key(Index i) const
+{
+    return item(i).first;
+}
+
+/**
+ * Takes a slot from the free list (or the next one never used, growing the
+ * storage) and constructs the item in it. Throws std::length_error when
+ * every slot is in use.
+ */
+template <class Key, class Value, class Slots>
+typename SlotAVLTree<Key, Value, Slots>::Index SlotAVLTree<Key, Value, Slots>::allocateSlot(const Item &keyValuePair,
+                                                                                          Index parent)
+{
+    Index i;
+    if (freeList_ != NIL)
+    {
+        i = freeList_;
+        freeList_ = slot(i).parent;
+    }
+    else
+    {
+        if (used_ == Slots::limit())
+        {
+            throw std::length_error("no free slot left in the tree");
+        }
+        slots_.grow(used_);
+        i = used_++;
+    }
+    Slot &s = slot(i);
+    new (&s.item) Item(keyValuePair);
+    s.parent = parent;
+    s.left = NIL;
+    s.right = NIL;
+    s.balance = 0;
+    ++size_;
+    return i;
+}
+
+/**
+ * Destroys the item in slot i and pushes the slot onto the free list.
+ */
+template <class Key, class Value, class Slots>
+void SlotAVLTree<Key, Value, Slots>::freeSlot(Index i)
+{
+    item(i).~Item();
+    slot(i).parent = freeList_;
+    freeList_ = i;
+    --size_;
+}
+
+/**
+ * Grows the storage to as many slots as other has used, takes over its links
+ * and free list and copy-constructs each of its items in the same slot. Only
+ * called on an empty tree. If an item's copy throws, the items copied so far
+ * are destroyed and the tree is left empty.
+ */
+template <class Key, class Value, class Slots>
+void SlotAVLTree<Key, Value, Slots>::copyFrom(const SlotAVLTree &other)
+{
+    for (Index i = 0; i < other.used_; ++i)
+    {
+        slots_.grow(i);
+        slot(i).parent = other.slot(i).parent;
+        slot(i).left = other.slot(i).left;
+        slot(i).right = other.slot(i).right;
+        slot(i).balance = other.slot(i).balance;
+    }
+    Index first = other.extreme(true);
+    for (Index i = first; i != NIL; i = other.successor(i))
+    {
+        try
+        {
+            new (&slot(i).item) Item(other.item(i));
+        }
+        catch (...)
+        {
+            for (Index j = first; j != i; j = other.successor(j))
+            {
+                item(j).~Item();
+            }
+            slots_.release();
+            throw;
+        }
+    }
+    root_ = other.root_;
+    freeList_ = other.freeList_;
+    used_ = other.used_;
+    size_ = other.size_;
+}
+
+/**
+ * Returns true if tree is empty
+ */
+template <class Key, class Value, class Slots>
+bool SlotAVLTree<Key, Value, Slots>::empty() const
+{
+    return root_ == NIL;
+}
+
+/**
+ * Returns the number of items in the tree.
+ */
+template <class Key, class Value, class Slots>
+size_t SlotAVLTree<Key, Value, Slots>::size() const
+{
+    return size_;
+}
+
+/**
+ * Returns the number of slots the storage holds (live, free or not yet
+ * handed out).
+ */
+template <class Key, class Value, class Slots>
+size_t SlotAVLTree<Key, Value, Slots>::capacity() const
+{
+    return slots_.capacity();
+}
+
+/**
+ * Returns the size of one slot, i.e. the per-entry cost of the tree.
+ */
+template <class Key, class Value, class Slots>
+size_t SlotAVLTree<Key, Value, Slots>::slotBytes()
+{
+    return sizeof(Slot);
+}
+
+/**
+ * Destroys every item and releases the storage. Walks in order through the
+ * links, which destroying an item leaves intact, so no stack is needed.
+ */
+template <class Key, class Value, class Slots>
+void SlotAVLTree<Key, Value, Slots>::clear()
+{
+    if (!std::is_trivially_destructible<Item>::value)
+    {
+        Index i = extreme(true);
+        while (i != NIL)
+        {
+            Index next = successor(i);
+            item(i).~Item();
+            i = next;
+        }
+    }
+    slots_.release();
+    root_ = NIL;
+    freeList_ = NIL;
+    used_ = 0;
+    size_ = 0;
+}
+
+template <class Key, class Value, class Slots>
+typename SlotAVLTree<Key, Value, Slots>::iterator SlotAVLTree<Key, Value, Slots>::begin() const
+{
+    return iterator(this, extreme(true));
+}
+
+template <class Key, class Value, class Slots>
+typename SlotAVLTree<Key, Value, Slots>::iterator SlotAVLTree<Key, Value, Slots>::end() const
+{
+    return iterator(this, NIL);
+}
+
+/**
+ * Returns a reverse iterator to the largest item.
+ */
+template <class Key, class Value, class Slots>
+typename SlotAVLTree<Key, Value, Slots>::reverse_iterator SlotAVLTree<Key, Value, Slots>::rbegin() const
+{
+    return reverse_iterator(end());
+}
+
+/**
+ * Returns a reverse iterator to one before the smallest item.
+ */
+template <class Key, class Value, class Slots>
+typename SlotAVLTree<Key, Value, Slots>::reverse_iterator SlotAVLTree<Key, Value, Slots>::rend() const
+{
+    return reverse_iterator(begin());
+}
+
+template <class Key, class Value, class Slots>
+typename SlotAVLTree<Key, Value, Slots>::iterator SlotAVLTree<Key, Value, Slots>::find(const Key &k) const
+{
+    return iterator(this, internalFind(k));
+}
+
+/**
+ * Finger search: looks up key starting from the slot hint points at rather
+ * than from the root, climbing only until a subtree's key range contains
+ * key, so it costs O(log d) when key is d positions away from the hint. An
+ * end() hint searches from the root.
+ */
+template <class Key, class Value, class Slots>
+typename SlotAVLTree<Key, Value, Slots>::iterator SlotAVLTree<Key, Value, Slots>::find_from(const iterator &hint,
+                                                                                           const Key &k) const
+{
+    Index c = fingerStart(hint.current_, k);
+    while (c != NIL)
+    {
+        const Key &ck = key(c);
+        if (k < ck)
+        {
+            c = slot(c).left;
+        }
+        else if (ck < k)
+        {
+            c = slot(c).right;
+        }
+        else
+        {
+            break;
+        }
+    }
+    return iterator(this, c);
+}
+
+/**
+ * Returns an iterator to the first item whose key is not less than key, or
+ * end() if there is none.
+ */
+template <class Key, class Value, class Slots>
+typename SlotAVLTree<Key, Value, Slots>::iterator SlotAVLTree<Key, Value, Slots>::lower_bound(const Key &k) const
+{
+    Index best = NIL;
+    Index c = root_;
+    while (c != NIL)
+    {
+        if (key(c) < k)
+        {
+            c = slot(c).right;
+        }
+        else
+        {
+            best = c;
+            c = slot(c).left;
+        }
+    }
+    return iterator(this, best);
+}
+
+/**
+ * Returns an iterator to the first item whose key is greater than key, or
+ * end() if there is none.
+ */
+template <class Key, class Value, class Slots>
+typename SlotAVLTree<Key, Value, Slots>::iterator SlotAVLTree<Key, Value, Slots>::upper_bound(const Key &k) const
+{
+    Index best = NIL;
+    Index c = root_;
+    while (c != NIL)
+    {
+        if (k < key(c))
+        {
+            best = c;
+            c = slot(c).left;
+        }
+        else
+        {
+            c = slot(c).right;
+        }
+    }
+    return iterator(this, best);
+}
+
+/**
+ * Returns the range [lower_bound(key), upper_bound(key)), which holds the
+ * item with the given key if there is one.
+ */
+template <class Key, class Value, class Slots>
+std::pair<typename SlotAVLTree<Key, Value, Slots>::iterator, typename SlotAVLTree<Key, Value, Slots>::iterator>
+SlotAVLTree<Key, Value, Slots>::equal_range(const Key &k) const
+{
+    return std::make_pair(lower_bound(k), upper_bound(k));
+}
+
+/**
+ * Returns 1 if key is in the tree and 0 otherwise.
+ */
+template <class Key, class Value, class Slots>
+size_t SlotAVLTree<Key, Value, Slots>::count(const Key &k) const
+{
+    return internalFind(k) != NIL ? 1 : 0;
+}
+
+/**
+ * Updates or inserts in a single descent: if key is present, calls
+ * fnIfPresent(value) on its value in place; otherwise inserts key with the
+ * value returned by makeIfAbsent(). Returns an iterator to the item.
+ */
+template <class Key, class Value, class Slots>
+template <typename Update, typename Make>
+typename SlotAVLTree<Key, Value, Slots>::iterator
+SlotAVLTree<Key, Value, Slots>::upsert(const Key &k, Update fnIfPresent, Make makeIfAbsent)
+{
+    Index parent = NIL;
+    Index c = root_;
+    while (c != NIL)
+    {
+        parent = c;
+        const Key &ck = key(c);
+        if (k < ck)
+        {
+            c = slot(c).left;
+        }
+        else if (ck < k)
+        {
+            c = slot(c).right;
+        }
+        else
+        {
+            fnIfPresent(item(c).second);
+            return iterator(this, c);
+        }
+    }
+    return iterator(this, attachLeaf(parent, Item(k, makeIfAbsent())));
+}
+
+/**
+ * Calls fn(value) on the value stored under key, in place, and returns true;
+ * returns false (without calling fn) if key is not in the tree.
+ */
+template <class Key, class Value, class Slots>
+template <typename Update>
+bool SlotAVLTree<Key, Value, Slots>::modify(const Key &k, Update fn)
+{
+    Index c = internalFind(k);
+    if (c == NIL)
+    {
+        return false;
+    }
+    fn(item(c).second);
+    return true;
+}
+
+/**
+ * @precondition The key exists in the map
+ * Returns the value associated with the key
+ */
+template <class Key, class Value, class Slots>
+Value &SlotAVLTree<Key, Value, Slots>::operator[](const Key &key)
+{
+    Index i = internalFind(key);
+    if (i == NIL)
+        throw std::out_of_range("Invalid key");
+    return item(i).second;
+}
+
+template <class Key, class Value, class Slots>
+Value const &SlotAVLTree<Key, Value, Slots>::operator[](const Key &key) const
+{
+    Index i = internalFind(key);
+    if (i == NIL)
+        throw std::out_of_range("Invalid key");
+    return item(i).second;
+}
+
+template <class Key, class Value, class Slots>
+typename SlotAVLTree<Key, Value, Slots>::Index SlotAVLTree<Key, Value, Slots>::internalFind(const Key &k) const
+{
+    Index c = root_;
+    while (c != NIL)
+    {
+        const Key &ck = key(c);
+        if (k < ck)
+        {
+            c = slot(c).left;
+        }
+        else if (ck < k)
+        {
+            c = slot(c).right;
+        }
+        else
+        {
+            return c;
+        }
+    }
+    return NIL;
+}
+
+template <class Key, class Value, class Slots>
+typename SlotAVLTree<Key, Value, Slots>::Index SlotAVLTree<Key, Value, Slots>::successor(Index i) const
+{
+    if (slot(i).right != NIL)
+    {
+        Index c = slot(i).right;
+        while (slot(c).left != NIL)
+        {
+            c = slot(c).left;
+        }
+        return c;
+    }
+    Index p = slot(i).parent;
+    while (p != NIL && slot(p).right == i)
+    {
+        i = p;
+        p = slot(p).parent;
+    }
+    return p;
+}
+
+template <class Key, class Value, class Slots>
+typename SlotAVLTree<Key, Value, Slots>::Index SlotAVLTree<Key, Value, Slots>::predecessor(Index i) const
+{
+    if (slot(i).left != NIL)
+    {
+        Index c = slot(i).left;
+        while (slot(c).right != NIL)
+        {
+            c = slot(c).right;
+        }
+        return c;
+    }
+    Index p = slot(i).parent;
+    while (p != NIL && slot(p).left == i)
+    {
+        i = p;
+        p = slot(p).parent;
+    }
+    return p;
+}
+
+/**
+ * Returns the smallest (or, with leftmost false, largest) item's slot, or
+ * NIL if the tree is empty.
+ */
+template <class Key, class Value, class Slots>
+typename SlotAVLTree<Key, Value, Slots>::Index SlotAVLTree<Key, Value, Slots>::extreme(bool leftmost) const
+{
+    Index c = root_;
+    if (c != NIL)
+    {
+        for (Index next = leftmost ? slot(c).left : slot(c).right; next != NIL;
+             next = leftmost ? slot(c).left : slot(c).right)
+        {
+            c = next;
+        }
+    }
+    return c;
+}
+
+/**
+ * Climbs from hint to the lowest ancestor whose subtree must hold key if it
+ * is in the tree; a NIL hint starts at the root.
+ */
+template <class Key, class Value, class Slots>
+typename SlotAVLTree<Key, Value, Slots>::Index SlotAVLTree<Key, Value, Slots>::fingerStart(Index hint,
+                                                                                         const Key &k) const
+{
+    if (hint == NIL)
+    {
+        return root_;
+    }
+    Index c = hint;
+    if (k < key(c))
+    {
+        while (slot(c).parent != NIL)
+        {
+            Index p = slot(c).parent;
+            if (slot(p).right == c && key(p) < k)
+            {
+                break;
+            }
+            c = p;
+        }
+    }
+    else if (key(c) < k)
+    {
+        while (slot(c).parent != NIL)
+        {
+            Index p = slot(c).parent;
+            if (slot(p).left == c && k < key(p))
+            {
+                break;
+            }
+            c = p;
+        }
+    }
+    return c;
+}
+
+/**
+ * Points the link that referred to oldChild (in parent, or the root) at newChild.
+ */
+template <class Key, class Value, class Slots>
+void SlotAVLTree<Key, Value, Slots>::replaceChild(Index parent, Index oldChild, Index newChild)
+{
+    if (parent == NIL)
+    {
+        root_ = newChild;
+    }
+    else if (slot(parent).left == oldChild)
+    {
+        slot(parent).left = newChild;
+    }
+    else
+    {
+        slot(parent).right = newChild;
+    }
+}
+
+/*
+ * If key is already in the tree, the current value is overwritten with the
+ * updated value.
+ */
+template <class Key, class Value, class Slots>
+void SlotAVLTree<Key, Value, Slots>::insert(const std::pair<const Key, Value> &keyValuePair)
+{
+    Index parent = NIL;
+    Index c = root_;
+
+    // walking down to the insertion point
+    while (c != NIL)
+    {
+        parent = c;
+        const Key &ck = key(c);
+        if (keyValuePair.first < ck)
+        {
+            c = slot(c).left;
+        }
+        else if (ck < keyValuePair.first)
+        {
+            c = slot(c).right;
+        }
+        else
+        {
+            item(c).second = keyValuePair.second;
+            return;
+        }
+    }
+
+    attachLeaf(parent, keyValuePair);
+}
+
+/**
+ * Puts keyValuePair in a new slot linked under parent (or as the root when
+ * parent is NIL) on the side its key belongs, retraces the balances up from
+ * it and returns the new slot.
+ */
+template <class Key, class Value, class Slots>
+typename SlotAVLTree<Key, Value, Slots>::Index SlotAVLTree<Key, Value, Slots>::attachLeaf(Index parent,
+                                                                                        const Item &keyValuePair)
+{
+    Index n = allocateSlot(keyValuePair, parent);
+    if (parent == NIL)
+    {
+        root_ = n;
+        return n;
+    }
+    if (keyValuePair.first < key(parent))
+    {
+        slot(parent).left = n;
+    }
+    else
+    {
+        slot(parent).right = n;
+    }
+
+    // retracing: the subtree under parent grew by one level on c's side
+    Index c = n;
+    while (parent != NIL)
+    {
+        slot(parent).balance += (slot(parent).left == c) ? -1 : 1;
+        int8_t b = slot(parent).balance;
+        if (b == 0)
+        {
+            break;
+        }
+        if (b == 2 || b == -2)
+        {
+            rebalance(parent);
+            break;
+        }
+        c = parent;
+        parent = slot(parent).parent;
+    }
+    return n;
+}
+
+template <class Key, class Value, class Slots>
+void SlotAVLTree<Key, Value, Slots>::remove(const Key &key)
+{
+    Index n = internalFind(key);
+    if (n != NIL)
+    {
+        removeSlot(n);
+    }
+}
+
+/**
+ * Removes the smallest item, if any.
+ */
+template <class Key, class Value, class Slots>
+void SlotAVLTree<Key, Value, Slots>::pop_min()
+{
+    if (root_ != NIL)
+    {
+        removeSlot(extreme(true));
+    }
+}
+
+/**
+ * Removes the largest item, if any.
+ */
+template <class Key, class Value, class Slots>
+void SlotAVLTree<Key, Value, Slots>::pop_max()
+{
+    if (root_ != NIL)
+    {
+        removeSlot(extreme(false));
+    }
+}
+
+/*
+ * As in AVLTree, a node with 2 children is swapped with its predecessor
+ * first so that the node actually unlinked has at most one child. Slots are
+ * relinked, not copied, so the other items never move.
+ */
+template <class Key, class Value, class Slots>
+void SlotAVLTree<Key, Value, Slots>::removeSlot(Index n)
+{
+    if (slot(n).left != NIL && slot(n).right != NIL)
+    {
+        nodeSwap(n, predecessor(n));
+    }
+
+    Index child = (slot(n).left != NIL) ? slot(n).left : slot(n).right;
+    Index p = slot(n).parent;
+    bool fromLeft = (p != NIL && slot(p).left == n);
+    replaceChild(p, n, child);
+    if (child != NIL)
+    {
+        slot(child).parent = p;
+    }
+    freeSlot(n);
+
+    // retracing: the subtree under p lost one level on one side
+    while (p != NIL)
+    {
+        slot(p).balance += fromLeft ? 1 : -1;
+        int8_t b = slot(p).balance;
+        if (b == 1 || b == -1)
+        {
+            break;
+        }
+        if (b == 2 || b == -2)
+        {
+            p = rebalance(p);
+            // a rotation around a balanced child keeps the height
+            if (slot(p).balance != 0)
+            {
+                break;
+            }
+        }
+        Index gp = slot(p).parent;
+        fromLeft = (gp != NIL && slot(gp).left == p);
+        p = gp;
+    }
+}
+
+/**
+ * Exchanges the tree positions (links and balance) of two slots.
+ */
+template <class Key, class Value, class Slots>
+void SlotAVLTree<Key, Value, Slots>::nodeSwap(Index n1, Index n2)
+{
+    if (n1 == n2 || n1 == NIL || n2 == NIL)
+    {
+        return;
+    }
+    // make n1 the upper one if they are adjacent
+    if (slot(n1).parent == n2)
+    {
+        std::swap(n1, n2);
+    }
+    Slot &a = slot(n1);
+    Slot &b = slot(n2);
+    Index ap = a.parent, al = a.left, ar = a.right;
+    Index bp = b.parent, bl = b.left, br = b.right;
+
+    if (bp == n1)
+    {
+        // n2 is a child of n1
+        replaceChild(ap, n1, n2);
+        b.parent = ap;
+        if (al == n2)
+        {
+            b.left = n1;
+            b.right = ar;
+            if (ar != NIL)
+                slot(ar).parent = n2;
+        }
+        else
+        {
+            b.right = n1;
+            b.left = al;
+            if (al != NIL)
+                slot(al).parent = n2;
+        }
+        a.parent = n2;
+    }
+    else
+    {
+        replaceChild(ap, n1, n2);
+        replaceChild(bp, n2, n1);
+        b.parent = ap;
+        a.parent = bp;
+        b.left = al;
+        b.right = ar;
+        if (al != NIL)
+            slot(al).parent = n2;
+        if (ar != NIL)
+            slot(ar).parent = n2;
+    }
+    a.left = bl;
+    a.right = br;
+    if (bl != NIL)
+        slot(bl).parent = n1;
+    if (br != NIL)
+        slot(br).parent = n1;
+    std::swap(a.balance, b.balance);
+}
+
+/**
+ * Rotates the right child of n above it, updating both balances.
+ */
+template <class Key, class Value, class Slots>
+void SlotAVLTree<Key, Value, Slots>::rotateLeft(Index n)
+{
+    Index r = slot(n).right;
+    Index p = slot(n).parent;
+
+    slot(n).right = slot(r).left;
+    if (slot(r).left != NIL)
+    {
+        slot(slot(r).left).parent = n;
+    }
+    replaceChild(p, n, r);
+    slot(r).parent = p;
+    slot(r).left = n;
+    slot(n).parent = r;
+
+    int8_t nb = slot(n).balance;
+    int8_t rb = slot(r).balance;
+    nb = (int8_t)(nb - 1 - std::max<int8_t>(rb, 0));
+    rb = (int8_t)(rb - 1 + std::min<int8_t>(nb, 0));
+    slot(n).balance = nb;
+    slot(r).balance = rb;
+}
+
+/**
+ * Rotates the left child of n above it, updating both balances.
+ */
+template <class Key, class Value, class Slots>
+void SlotAVLTree<Key, Value, Slots>::rotateRight(Index n)
+{
+    Index l = slot(n).left;
+    Index p = slot(n).parent;
+
+    slot(n).left = slot(l).right;
+    if (slot(l).right != NIL)
+    {
+        slot(slot(l).right).parent = n;
+    }
+    replaceChild(p, n, l);
+    slot(l).parent = p;
+    slot(l).right = n;
+    slot(n).parent = l;
+
+    int8_t nb = slot(n).balance;
+    int8_t lb = slot(l).balance;
+    nb = (int8_t)(nb + 1 - std::min<int8_t>(lb, 0));
+    lb = (int8_t)(lb + 1 + std::max<int8_t>(nb, 0));
+    slot(n).balance = nb;
+    slot(l).balance = lb;
+}
+
+/**
+ * Fixes a node whose balance is +/-2 with a single or double rotation and
+ * returns the new root of its subtree.
+ */
+template <class Key, class Value, class Slots>
+typename SlotAVLTree<Key, Value, Slots>::Index SlotAVLTree<Key, Value, Slots>::rebalance(Index n)
+{
+    if (slot(n).balance == 2)
+    {
+        Index r = slot(n).right;
+        if (slot(r).balance < 0)
+        {
+            rotateRight(r);
+        }
+        rotateLeft(n);
+    }
+    else
+    {
+        Index l = slot(n).left;
+        if (slot(l).balance > 0)
+        {
+            rotateLeft(l);
+        }
+        rotateRight(n);
+    }
+    return slot(n).parent;
+}
+
+/**
+ * Returns the height of the subtree at n, or -1 if it is not AVL-balanced.
+ */
+template <class Key, class Value, class Slots>
+int SlotAVLTree<Key, Value, Slots>::calculateHeight(Index n) const
+{
+    if (n == NIL)
+    {
+        return 0;
+    }
+    int l = calculateHeight(slot(n).left);
+    int r = calculateHeight(slot(n).right);
+    if (l == -1 || r == -1 || std::abs(l - r) > 1)
+    {
+        return -1;
+    }
+    return 1 + std::max(l, r);
+}
+
+/**
+ * Return true if the tree is balanced.
+ */
+template <class Key, class Value, class Slots>
+bool SlotAVLTree<Key, Value, Slots>::isBalanced() const
+{
+    return calculateHeight(root_) != -1;
+}
+
+/**
+ * Prints the tree sideways, one item per line in descending key order and
+ * indented by its depth, so the root is at the left margin and each node's
+ * right subtree is above it.
+ */
+template <class Key, class Value, class Slots>
+void SlotAVLTree<Key, Value, Slots>::print() const
+{
+    std::vector<std::pair<Index, int> > stack;
+    Index c = root_;
+    int depth = 0;
+    while (c != NIL || !stack.empty())
+    {
+        // reverse in-order: right subtree, the node, then the left subtree
+        while (c != NIL)
+        {
+            stack.push_back(std::make_pair(c, depth));
+            c = slot(c).right;
+            ++depth;
+        }
+        c = stack.back().first;
+        depth = stack.back().second;
+        stack.pop_back();
+        std::cout << std::string(4 * depth, ' ') << "[" << key(c) << ", " << item(c).second << "]\n";
+        c = slot(c).left;
+        ++depth;
+    }
+    std::cout << "\n";
+}
+
+/*
+------------------------------------------------
+End implementations for the SlotAVLTree class.
+------------------------------------------------
+*/
+
+#endif
@@ -0,0 +1,166 @@
+#ifndef SMALLAVLBST_H
+#define SMALLAVLBST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include "avlbst.h"
+
+/**
+ * An AVLTree whose first K nodes live in slots inside the tree object, so a
+ * map that never holds more than K items makes no allocations at all and
+ * all of its nodes share the tree's own cache lines. Past K the tree keeps
+ * growing with nodes from its resource as usual; slots freed by removes are
+ * taken again before the resource is asked for more. The interface,
+ * iterators and balancing are exactly those of AVLTree, and because nodes
+ * never move between the slots and the resource, iterators and references
+ * stay valid across the switch in both directions.
+ *
+ * Every slot adds sizeof(AVLNode<Key, Value>) to the tree object whether or
+ * not it is in use (48 bytes for int keys and values, against about 64 for
+ * the same node on the heap with the allocator's header), so a map only
+ * comes out smaller than an AVLTree once about three quarters of its slots
+ * are in use. K should match the size most of the trees actually reach; the
+ * default of 4 keeps an empty tree at 328 bytes for int keys and values.
+ * Trees are not copyable, since the nodes in the slots cannot be shared.
+ */
+template <class Key, class Value, size_t K = 4>
+class SmallAVLTree : public AVLTree<Key, Value>
+{
+    static_assert(K >= 1 && K <= 255, "SmallAVLTree keeps between 1 and 255 nodes inline");
+
+public:
+    SmallAVLTree();
+    explicit SmallAVLTree(NodeResource *resource);
+    virtual ~SmallAVLTree();
+
+    static constexpr size_t inlineCapacity() { return K; }
+    size_t inlineNodes() const;
+
+protected:
+    virtual void destroyNode(Node<Key, Value> *n);
+    virtual AVLNode<Key, Value> *newNode(const Key &key, const Value &value, AVLNode<Key, Value> *parent);
+
+    typedef typename std::aligned_storage<sizeof(AVLNode<Key, Value>), alignof(AVLNode<Key, Value>)>::type Slot;
+
+    bool isInline(Node<Key, Value> *n) const;
+
+    Slot slots_[K];
+    // indices of the free slots, the next one to use last
+    uint8_t free_[K];
+    uint8_t freeCount_;
+
+private:
+    SmallAVLTree(const SmallAVLTree &);
+    SmallAVLTree &operator=(const SmallAVLTree &);
+};
+
+/*
+  ----------------------------------------------------
+  Begin implementations for the SmallAVLTree class.
+  ----------------------------------------------------
+*/
+
+/**
+ * Default constructor, with every slot free. Slot 0 is used first so that a
+ * small tree's nodes start at the front of the array.
+ */
+template <class Key, class Value, size_t K>
+SmallAVLTree<Key, Value, K>::SmallAVLTree() : freeCount_((uint8_t)K)
+{
+    for (size_t i = 0; i < K; ++i)
+    {
+        free_[i] = (uint8_t)(K - 1 - i);
+    }
+}
+
+/**
+ * Constructor for a tree whose nodes past the first K are allocated from
+ * resource, which must outlive the tree.
+ */
+template <class Key, class Value, size_t K>
+SmallAVLTree<Key, Value, K>::SmallAVLTree(NodeResource *resource)
+    : AVLTree<Key, Value>(resource), freeCount_((uint8_t)K)
+{
+    for (size_t i = 0; i < K; ++i)
+    {
+        free_[i] = (uint8_t)(K - 1 - i);
+    }
+}
+
+/**
+ * Clears the tree here so that destroyNode still knows about the slots.
+ */
+template <class Key, class Value, size_t K>
+SmallAVLTree<Key, Value, K>::~SmallAVLTree()
+{
+    this->clear();
+}
+
+/**
+ * Returns how many of the tree's nodes are in the inline slots.
+ */
+template <class Key, class Value, size_t K>
+size_t SmallAVLTree<Key, Value, K>::inlineNodes() const
+{
+    return K - freeCount_;
+}
+
+/**
+ * Whether n is one of the inline slots.
+ */
+template <class Key, class Value, size_t K>
+bool SmallAVLTree<Key, Value, K>::isInline(Node<Key, Value> *n) const
+{
+    const void *p = n;
+    std::less<const void *> before;
+    return !before(p, slots_) && before(p, slots_ + K);
+}
+
+/**
+ * Returns an inline node to the free slots; other nodes go back to the
+ * resource (or the compaction block) as in AVLTree.
+ */
+template <class Key, class Value, size_t K>
+void SmallAVLTree<Key, Value, K>::destroyNode(Node<Key, Value> *n)
+{
+    if (!isInline(n))
+    {
+        AVLTree<Key, Value>::destroyNode(n);
+        return;
+    }
+    n->~Node<Key, Value>();
+    --this->usage_.liveNodes;
+    free_[freeCount_++] = (uint8_t)(reinterpret_cast<Slot *>(n) - slots_);
+}
+
+/**
+ * Builds the node in a free slot if there is one, and allocates it from the
+ * resource otherwise. Inline nodes count as live nodes but not as
+ * allocations or bytes taken from the resource.
+ */
+template <class Key, class Value, size_t K>
+AVLNode<Key, Value> *SmallAVLTree<Key, Value, K>::newNode(const Key &key, const Value &value,
+                                                          AVLNode<Key, Value> *parent)
+{
+    if (freeCount_ == 0)
+    {
+        return AVLTree<Key, Value>::newNode(key, value, parent);
+    }
+    AVLNode<Key, Value> *n = new (&slots_[free_[freeCount_ - 1]]) AVLNode<Key, Value>(key, value, parent);
+    --freeCount_;
+    this->usage_.nodeBytes = sizeof(AVLNode<Key, Value>);
+    this->nodeAlign_ = alignof(AVLNode<Key, Value>);
+    ++this->usage_.liveNodes;
+    return n;
+}
+
+/*
+  --------------------------------------------------
+  End implementations for the SmallAVLTree class.
+  --------------------------------------------------
+*/
+
+#endif
@@ -0,0 +1,286 @@
+#ifndef SPLAYBST_H
+#define SPLAYBST_H
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <algorithm>
+#include "bst.h"
+
+/**
+ * A self-adjusting (splay) tree. Every insert, find and remove moves the
+ * accessed node to the root with zig, zig-zig and zig-zag steps, so keys that
+ * are looked up often stay near the top and cost far less than a full
+ * O(log n) descent. Operations are O(log n) amortized.
+ *
+ * Splay trees need no per-node balance information, so they use the plain
+ * Node class. Because lookups restructure the tree, find and operator[] are
+ * non-const here and hide the const versions in BinarySearchTree. Splaying
+ * only relinks nodes, so outstanding iterators stay valid.
+ */
+template <class Key, class Value>
+class SplayTree : public BinarySearchTree<Key, Value>
+{
+public:
+    virtual void insert(const std::pair<const Key, Value> &new_item);
+    virtual void remove(const Key &key);
+
+    typename BinarySearchTree<Key, Value>::iterator find(const Key &key);
+    Value &operator[](const Key &key);
+
+protected:
+    // Helper functions
+    virtual Node<Key, Value> *attachLeaf(Node<Key, Value> *parent, const std::pair<const Key, Value> &new_item);
+    virtual void removeNode(Node<Key, Value> *n);
+    Node<Key, Value> *splayFind(const Key &key);
+    void splay(Node<Key, Value> *n);
+    void rotateUp(Node<Key, Value> *n);
+};
+
+/*
+  -----------------------------------------------
+  Begin implementations for the SplayTree class.
+  -----------------------------------------------
+*/
+
+/*
+ * If key is already in the tree, the current value is overwritten with the
+ * updated value. Either way the node holding the key ends up at the root.
+ */
+template <class Key, class Value>
+void SplayTree<Key, Value>::insert(const std::pair<const Key, Value> &new_item)
+{
+    Node<Key, Value> *parent = nullptr;
+    Node<Key, Value> *c = this->root_;
+
+    // walking down to the insertion point
+    while (c != nullptr)
+    {
+        parent = c;
+        if (new_item.first < c->getKey())
+        {
+            c = c->getLeft();
+        }
+        else if (new_item.first > c->getKey())
+        {
+            c = c->getRight();
+        }
+        else
+        {
+            c->setValue(new_item.second);
+            splay(c);
+            return;
+        }
+    }
+
+    attachLeaf(parent, new_item);
+}
+
+/**
+ * Links a new node under parent and splays it to the root.
+ */
+template <class Key, class Value>
+Node<Key, Value> *SplayTree<Key, Value>::attachLeaf(Node<Key, Value> *parent,
+                                                    const std::pair<const Key, Value> &new_item)
+{
+    Node<Key, Value> *n = BinarySearchTree<Key, Value>::attachLeaf(parent, new_item);
+    splay(n);
+    return n;
+}
+
+/**
+ * Looks the key up, splaying as find() does, and removes its node.
+ */
+template <class Key, class Value>
+void SplayTree<Key, Value>::remove(const Key &key)
+{
+    Node<Key, Value> *n = splayFind(key);
+    if (n != nullptr)
+    {
+        removeNode(n);
+    }
+}
+
+/**
+ * Splays the node to remove up to the root, then joins its two subtrees by
+ * splaying the largest node of the left subtree (which then has no right
+ * child) and hanging the right subtree off it.
+ */
+template <class Key, class Value>
+void SplayTree<Key, Value>::removeNode(Node<Key, Value> *n)
+{
+    splay(n);
+    this->noteUnlinking(n);
+    Node<Key, Value> *l = n->getLeft();
+    Node<Key, Value> *r = n->getRight();
+    if (l == nullptr)
+    {
+        this->root_ = r;
+        if (r != nullptr)
+        {
+            r->setParent(nullptr);
+        }
+    }
+    else
+    {
+        // detaching the left subtree and splaying its maximum to its root
+        l->setParent(nullptr);
+        this->root_ = l;
+        Node<Key, Value> *m = l;
+        while (m->getRight() != nullptr)
+        {
+            m = m->getRight();
+        }
+        splay(m);
+        m->setRight(r);
+        if (r != nullptr)
+        {
+            r->setParent(m);
+        }
+    }
+    this->destroyNode(n);
+}
+
+/**
+ * Returns an iterator to the item with the given key (or end()), splaying
+ * the last node visited so repeated lookups of hot keys stay cheap.
+ */
+template <class Key, class Value>
+typename BinarySearchTree<Key, Value>::iterator SplayTree<Key, Value>::find(const Key &key)
+{
+    if (splayFind(key) == nullptr)
+    {
+        return this->end();
+    }
+    // the node is now the root, which the base class lookup checks first
+    return BinarySearchTree<Key, Value>::find(key);
+}
+
+/**
+ * @precondition The key exists in the map
+ * Returns the value associated with the key
+ */
+template <class Key, class Value>
+Value &SplayTree<Key, Value>::operator[](const Key &key)
+{
+    Node<Key, Value> *n = splayFind(key);
+    if (n == nullptr)
+        throw std::out_of_range("Invalid key");
+    return n->getValue();
+}
+
+/**
+ * Looks up a key and splays the node holding it, or the last node on the
+ * search path if the key is missing. Returns the node holding key or NULL.
+ */
+template <class Key, class Value>
+Node<Key, Value> *SplayTree<Key, Value>::splayFind(const Key &key)
+{
+    Node<Key, Value> *c = this->root_;
+    Node<Key, Value> *last = nullptr;
+    while (c != nullptr)
+    {
+        last = c;
+        if (key < c->getKey())
+        {
+            c = c->getLeft();
+        }
+        else if (key > c->getKey())
+        {
+            c = c->getRight();
+        }
+        else
+        {
+            break;
+        }
+    }
+    if (last != nullptr)
+    {
+        splay(last);
+    }
+    return c;
+}
+
+/**
+ * Moves n to the root.
+ */
+template <class Key, class Value>
+void SplayTree<Key, Value>::splay(Node<Key, Value> *n)
+{
+    while (n->getParent() != nullptr)
+    {
+        Node<Key, Value> *p = n->getParent();
+        Node<Key, Value> *g = p->getParent();
+        if (g == nullptr)
+        {
+            // zig
+            rotateUp(n);
+        }
+        else if ((g->getLeft() == p) == (p->getLeft() == n))
+        {
+            // zig-zig: rotate the parent first
+            rotateUp(p);
+            rotateUp(n);
+        }
+        else
+        {
+            // zig-zag
+            rotateUp(n);
+            rotateUp(n);
+        }
+    }
+}
+
+/**
+ * Rotates n above its parent (a right rotation if n is a left child, a left
+ * rotation otherwise).
+ */
+template <class Key, class Value>
+void SplayTree<Key, Value>::rotateUp(Node<Key, Value> *n)
+{
+    Node<Key, Value> *p = n->getParent();
+    Node<Key, Value> *g = p->getParent();
+
+    if (p->getLeft() == n)
+    {
+        p->setLeft(n->getRight());
+        if (n->getRight() != nullptr)
+        {
+            n->getRight()->setParent(p);
+        }
+        n->setRight(p);
+    }
+    else
+    {
+        p->setRight(n->getLeft());
+        if (n->getLeft() != nullptr)
+        {
+            n->getLeft()->setParent(p);
+        }
+        n->setLeft(p);
+    }
+    p->setParent(n);
+    n->setParent(g);
+
+    // changing pointers
+    if (g == nullptr)
+    {
+        this->root_ = n;
+    }
+    else if (g->getLeft() == p)
+    {
+        g->setLeft(n);
+    }
+    else
+    {
+        g->setRight(n);
+    }
+}
+
+/*
+  ---------------------------------------------
+  End implementations for the SplayTree class.
+  ---------------------------------------------
+*/
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef STATICAVLBST_H
+#define STATICAVLBST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include "slotavlbst.h"
+
+/**
+ * An AVL tree of at most N items whose nodes all live in an array inside the
+ * tree object and link to each other with 16-bit slot indices. It never
+ * allocates: a tree declared on the stack or as a static is the whole
+ * footprint, and a slot for int keys and values is 16 bytes. Removed slots
+ * are reused through a free list threaded through their parent links.
+ * Inserting into a full tree throws std::length_error; check full() first
+ * where that must not happen.
+ *
+ * The interface, iterator semantics and balancing are those of
+ * IndexedAVLTree (and so AVLTree), since both are SlotAVLTree, here over
+ * InlineSlots: items never move once inserted, so iterators and references
+ * to other items stay valid across inserts and removes. Constructing a tree
+ * touches none of the slots, so an empty tree costs nothing to create
+ * however large N is, and capacity() is a constant expression for sizing
+ * buffers alongside it.
+ */
+template <class Key, class Value, size_t N>
+class StaticAVLTree : public SlotAVLTree<Key, Value, InlineSlots<std::pair<const Key, Value>, uint16_t, N> >
+{
+    static_assert(N >= 1 && N < 0xFFFF, "StaticAVLTree holds between 1 and 65534 items");
+
+public:
+    bool full() const;
+    static constexpr size_t capacity() { return N; }
+};
+
+/*
+----------------------------------------------------
+Begin implementations for the StaticAVLTree class.
+----------------------------------------------------
+*/
+
+/**
+ * Returns true if another insert of a new key would throw.
+ */
+template <class Key, class Value, size_t N>
+bool StaticAVLTree<Key, Value, N>::full() const
+{
+    return this->size_ == N;
+}
+
+/*
+--------------------------------------------------
+End implementations for the StaticAVLTree class.
+--------------------------------------------------
+*/
+
+#endif
@@ -0,0 +1,825 @@
+#ifndef TRACE_BST_H
+#define TRACE_BST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "avlbst.h"
+
+// Binary traces of the calls made on a tree, for replaying a real access
+// pattern against any tree variant (see bst-replay). A trace is a 12-byte
+// header followed by one record per call:
+//
+//   header   "BSTTRACE", version, key bytes, value bytes, 0
+//   insert   1, key, value
+//   remove   2, key
+//   find     3, iterator, key
+//   begin    4, iterator
+//   next     5, iterator, count
+//   copy     6, iterator, source iterator
+//
+// Iterator ids and counts are unsigned LEB128 varints. Every iterator the
+// program gets from find() or begin(), or by copying another, is given an id
+// that later next records name, so iterators used in turn replay each from
+// its own position. Ids are reused once their iterator is destroyed. A run
+// of increments of one iterator is one next record. Keys and values are
+// stored as their raw bytes in the host's byte order, so they must be
+// trivially copyable, and a trace only replays on a machine of the same
+// endianness.
+
+enum TraceOp
+{
+    TRACE_INSERT = 1,
+    TRACE_REMOVE = 2,
+    TRACE_FIND = 3,
+    TRACE_BEGIN = 4,
+    TRACE_NEXT = 5,
+    TRACE_COPY = 6
+};
+
+/**
+ * The sizes of the keys and values a trace was recorded with.
+ */
+struct TraceHeader
+{
+    static const uint8_t VERSION = 2;
+
+    unsigned keyBytes;
+    unsigned valueBytes;
+
+    void write(std::ostream &out) const;
+    static TraceHeader read(std::istream &in);
+};
+
+/**
+ * One call read back from a trace. count is the number of increments of a
+ * next record and 1 for every other kind. iterator is the id of the iterator
+ * a find, begin, next or copy record sets or moves, and source the id of the
+ * iterator a copy record copies.
+ */
+template <class Key, class Value>
+struct TraceRecord
+{
+    TraceOp op;
+    uint64_t count;
+    uint32_t iterator;
+    uint32_t source;
+    Key key;
+    Value value;
+};
+
+/**
+ * Writes calls to a trace as they are made. Increments of one iterator are
+ * counted and only written out as one record when some other call (or
+ * flush()) ends the run. The stream must stay open while the writer is in
+ * use.
+ */
+template <class Key, class Value>
+class TraceWriter
+{
+    static_assert(std::is_trivially_copyable<Key>::value && std::is_trivially_copyable<Value>::value,
+                  "traced keys and values are stored as raw bytes");
+    static_assert(sizeof(Key) <= 255 && sizeof(Value) <= 255,
+                  "the trace header stores key and value sizes in one byte each");
+
+public:
+    explicit TraceWriter(std::ostream &out);
+    ~TraceWriter();
+
+    // The id of an iterator that is not traced.
+    static const uint32_t NO_ITERATOR = 0xFFFFFFFFu;
+
+    uint32_t acquireIterator();
+    void releaseIterator(uint32_t iterator);
+
+    void insert(const Key &key, const Value &value);
+    void remove(const Key &key);
+    void find(uint32_t iterator, const Key &key);
+    void begin(uint32_t iterator);
+    void next(uint32_t iterator);
+    void copy(uint32_t iterator, uint32_t source);
+    void flush();
+    size_t records() const;
+
+private:
+    TraceWriter(const TraceWriter &);
+    TraceWriter &operator=(const TraceWriter &);
+
+    void startRecord(TraceOp op);
+    void writePendingNext();
+    void writeVarint(uint64_t x);
+    template <typename T>
+    void writeRaw(const T &x);
+
+    std::ostream &out_;
+    uint32_t pendingIterator_;
+    uint64_t pendingNext_;
+    size_t records_;
+    uint32_t nextIterator_;
+    std::vector<uint32_t> freeIterators_;
+};
+
+/**
+ * Reads the records of a trace one at a time. The constructor reads the
+ * header and throws std::runtime_error if it is not a trace or was recorded
+ * with other key or value sizes; read() throws the same on a truncated or
+ * unknown record.
+ */
+template <class Key, class Value>
+class TraceReader
+{
+public:
+    explicit TraceReader(std::istream &in);
+
+    bool read(TraceRecord<Key, Value> &r);
+
+private:
+    uint64_t readVarint();
+    uint32_t readIterator();
+    template <typename T>
+    void readRaw(T &x);
+
+    std::istream &in_;
+};
+
+/**
+ * A tree of type Tree that writes insert(), remove(), find(), begin() and
+ * the copies and increments of the iterators those return to a TraceWriter
+ * while one is attached. Other calls (operator[], upsert(), lower_bound(),
+ * decrements and the rest) are not traced, and neither are find() or
+ * begin() made through a reference to the base tree.
+ */
+template <class Key, class Value, class Tree = AVLTree<Key, Value> >
+class TracedTree : public Tree
+{
+public:
+    /**
+     * Tree's iterator, which also traces its copies and increments under an
+     * iterator id taken from the writer. Moves hand the id over untraced.
+     */
+    class iterator : public Tree::iterator
+    {
+    public:
+        iterator();
+        iterator(const typename Tree::iterator &it, const TracedTree<Key, Value, Tree> *owner, uint32_t id);
+        iterator(const iterator &other);
+        iterator(iterator &&other);
+        ~iterator();
+
+        iterator &operator=(const iterator &other);
+        iterator &operator=(iterator &&other);
+        iterator &operator++();
+        iterator operator++(int);
+
+    private:
+        TraceWriter<Key, Value> *tracing() const;
+        void release();
+
+        const TracedTree<Key, Value, Tree> *owner_;
+        // the writer the id came from, which must still be attached
+        TraceWriter<Key, Value> *writer_;
+        uint32_t id_;
+    };
+
+    TracedTree();
+    virtual ~TracedTree();
+
+    void startTrace(TraceWriter<Key, Value> *writer);
+    void stopTrace();
+
+    void insert(const std::pair<const Key, Value> &keyValuePair);
+    void remove(const Key &key);
+    iterator find(const Key &key) const;
+    iterator begin() const;
+    iterator end() const;
+
+private:
+    TraceWriter<Key, Value> *writer_;
+};
+
+/**
+ * Returns the replayed iterator with the given id, growing iterators with
+ * end() as needed, so an id the trace never set reads as end().
+ */
+template <class Tree>
+typename Tree::iterator &tracedIterator(const Tree &tree, std::vector<typename Tree::iterator> &iterators, uint32_t id)
+{
+    if (id >= iterators.size())
+    {
+        iterators.resize((size_t)id + 1, tree.end());
+    }
+    return iterators[id];
+}
+
+/**
+ * Applies one record to tree. iterators holds the replayed iterators by id:
+ * find and begin set one, copy sets it to another, and next advances it by
+ * the record's count (stopping at the end). Inserted items keep the recorded
+ * value. Returns the iterator the record set or moved, or NULL for inserts
+ * and removes.
+ */
+template <class Tree, class Key, class Value>
+typename Tree::iterator *applyTraceRecord(Tree &tree, const TraceRecord<Key, Value> &r,
+                                          std::vector<typename Tree::iterator> &iterators)
+{
+    typename Tree::iterator *position = NULL;
+    switch (r.op)
+    {
+    case TRACE_INSERT:
+        tree.insert(std::make_pair(r.key, r.value));
+        break;
+    case TRACE_REMOVE:
+        tree.remove(r.key);
+        break;
+    case TRACE_FIND:
+        position = &tracedIterator(tree, iterators, r.iterator);
+        *position = tree.find(r.key);
+        break;
+    case TRACE_BEGIN:
+        position = &tracedIterator(tree, iterators, r.iterator);
+        *position = tree.begin();
+        break;
+    case TRACE_NEXT:
+        position = &tracedIterator(tree, iterators, r.iterator);
+        for (uint64_t i = 0; i < r.count && *position != tree.end(); ++i)
+        {
+            ++*position;
+        }
+        break;
+    case TRACE_COPY:
+    {
+        typename Tree::iterator source = tracedIterator(tree, iterators, r.source);
+        position = &tracedIterator(tree, iterators, r.iterator);
+        *position = source;
+        break;
+    }
+    }
+    return position;
+}
+
+/*
+  ----------------------------------------------
+  Begin implementations for the trace classes.
+  ----------------------------------------------
+*/
+
+/**
+ * Writes the 12-byte header.
+ */
+inline void TraceHeader::write(std::ostream &out) const
+{
+    char bytes[12] = {'B', 'S', 'T', 'T', 'R', 'A', 'C', 'E', (char)VERSION, (char)keyBytes, (char)valueBytes, 0};
+    out.write(bytes, sizeof(bytes));
+}
+
+/**
+ * Reads and checks the header at the start of a trace.
+ */
+inline TraceHeader TraceHeader::read(std::istream &in)
+{
+    char bytes[12];
+    if (!in.read(bytes, sizeof(bytes)) || std::memcmp(bytes, "BSTTRACE", 8) != 0)
+    {
+        throw std::runtime_error("not a tree trace");
+    }
+    if ((uint8_t)bytes[8] != VERSION)
+    {
+        throw std::runtime_error("unsupported trace version");
+    }
+    TraceHeader h;
+    h.keyBytes = (uint8_t)bytes[9];
+    h.valueBytes = (uint8_t)bytes[10];
+    return h;
+}
+
+/**
+ * Constructor, which writes the header straight away.
+ */
+template <class Key, class Value>
+TraceWriter<Key, Value>::TraceWriter(std::ostream &out)
+    : out_(out), pendingIterator_(NO_ITERATOR), pendingNext_(0), records_(0), nextIterator_(0)
+{
+    TraceHeader h;
+    h.keyBytes = sizeof(Key);
+    h.valueBytes = sizeof(Value);
+    h.write(out_);
+}
+
+/**
+ * Writes out any run of increments still pending.
+ */
+template <class Key, class Value>
+TraceWriter<Key, Value>::~TraceWriter()
+{
+    flush();
+}
+
+/**
+ * Returns an id for a new iterator, reusing those of destroyed ones first
+ * so that a replay needs as many positions as iterators lived at once.
+ */
+template <class Key, class Value>
+uint32_t TraceWriter<Key, Value>::acquireIterator()
+{
+    if (!freeIterators_.empty())
+    {
+        uint32_t id = freeIterators_.back();
+        freeIterators_.pop_back();
+        return id;
+    }
+    return nextIterator_++;
+}
+
+/**
+ * Marks the id of a destroyed iterator for reuse. Nothing is written: the
+ * record that next uses the id sets the replayed iterator anew.
+ */
+template <class Key, class Value>
+void TraceWriter<Key, Value>::releaseIterator(uint32_t iterator)
+{
+    freeIterators_.push_back(iterator);
+}
+
+template <class Key, class Value>
+void TraceWriter<Key, Value>::insert(const Key &key, const Value &value)
+{
+    startRecord(TRACE_INSERT);
+    writeRaw(key);
+    writeRaw(value);
+}
+
+template <class Key, class Value>
+void TraceWriter<Key, Value>::remove(const Key &key)
+{
+    startRecord(TRACE_REMOVE);
+    writeRaw(key);
+}
+
+template <class Key, class Value>
+void TraceWriter<Key, Value>::find(uint32_t iterator, const Key &key)
+{
+    startRecord(TRACE_FIND);
+    writeVarint(iterator);
+    writeRaw(key);
+}
+
+template <class Key, class Value>
+void TraceWriter<Key, Value>::begin(uint32_t iterator)
+{
+    startRecord(TRACE_BEGIN);
+    writeVarint(iterator);
+}
+
+/**
+ * Counts one increment of iterator towards the current run, ending the run
+ * first if it was of another iterator.
+ */
+template <class Key, class Value>
+void TraceWriter<Key, Value>::next(uint32_t iterator)
+{
+    if (iterator != pendingIterator_)
+    {
+        writePendingNext();
+        pendingIterator_ = iterator;
+    }
+    ++pendingNext_;
+}
+
+/**
+ * Records that iterator was made a copy of source.
+ */
+template <class Key, class Value>
+void TraceWriter<Key, Value>::copy(uint32_t iterator, uint32_t source)
+{
+    startRecord(TRACE_COPY);
+    writeVarint(iterator);
+    writeVarint(source);
+}
+
+/**
+ * Writes the pending run of increments, if any, and flushes the stream.
+ */
+template <class Key, class Value>
+void TraceWriter<Key, Value>::flush()
+{
+    writePendingNext();
+    out_.flush();
+}
+
+/**
+ * Returns the number of records written so far, counting a run of
+ * increments once it has been written.
+ */
+template <class Key, class Value>
+size_t TraceWriter<Key, Value>::records() const
+{
+    return records_;
+}
+
+/**
+ * Ends any run of increments and writes the op byte of a new record.
+ */
+template <class Key, class Value>
+void TraceWriter<Key, Value>::startRecord(TraceOp op)
+{
+    writePendingNext();
+    out_.put((char)op);
+    ++records_;
+}
+
+/**
+ * Writes the pending run of increments, if any, as one next record. Unlike
+ * flush() it leaves the stream alone, so records go out in the stream's
+ * own buffer-sized writes.
+ */
+template <class Key, class Value>
+void TraceWriter<Key, Value>::writePendingNext()
+{
+    if (pendingNext_ == 0)
+    {
+        return;
+    }
+    out_.put((char)TRACE_NEXT);
+    ++records_;
+    writeVarint(pendingIterator_);
+    writeVarint(pendingNext_);
+    pendingNext_ = 0;
+    pendingIterator_ = NO_ITERATOR;
+}
+
+/**
+ * Writes x as an unsigned LEB128 varint: 7 bits a byte, low bits first.
+ */
+template <class Key, class Value>
+void TraceWriter<Key, Value>::writeVarint(uint64_t x)
+{
+    while (x >= 0x80)
+    {
+        out_.put((char)((x & 0x7f) | 0x80));
+        x >>= 7;
+    }
+    out_.put((char)x);
+}
+
+template <class Key, class Value>
+template <typename T>
+void TraceWriter<Key, Value>::writeRaw(const T &x)
+{
+    out_.write(reinterpret_cast<const char *>(&x), sizeof(T));
+}
+
+/**
+ * Constructor, which reads and checks the header.
+ */
+template <class Key, class Value>
+TraceReader<Key, Value>::TraceReader(std::istream &in) : in_(in)
+{
+    TraceHeader h = TraceHeader::read(in_);
+    if (h.keyBytes != sizeof(Key) || h.valueBytes != sizeof(Value))
+    {
+        throw std::runtime_error("trace was recorded with other key or value sizes");
+    }
+}
+
+/**
+ * Reads the next record into r. Returns false at the end of the trace.
+ */
+template <class Key, class Value>
+bool TraceReader<Key, Value>::read(TraceRecord<Key, Value> &r)
+{
+    int op = in_.get();
+    if (op == std::char_traits<char>::eof())
+    {
+        return false;
+    }
+    r.op = (TraceOp)op;
+    r.count = 1;
+    r.iterator = TraceWriter<Key, Value>::NO_ITERATOR;
+    r.source = TraceWriter<Key, Value>::NO_ITERATOR;
+    switch (op)
+    {
+    case TRACE_INSERT:
+        readRaw(r.key);
+        readRaw(r.value);
+        break;
+    case TRACE_REMOVE:
+        readRaw(r.key);
+        break;
+    case TRACE_FIND:
+        r.iterator = readIterator();
+        readRaw(r.key);
+        break;
+    case TRACE_BEGIN:
+        r.iterator = readIterator();
+        break;
+    case TRACE_NEXT:
+        r.iterator = readIterator();
+        r.count = readVarint();
+        break;
+    case TRACE_COPY:
+        r.iterator = readIterator();
+        r.source = readIterator();
+        break;
+    default:
+        throw std::runtime_error("unknown trace record");
+    }
+    return true;
+}
+
+template <class Key, class Value>
+uint64_t TraceReader<Key, Value>::readVarint()
+{
+    uint64_t x = 0;
+    for (unsigned shift = 0;; shift += 7)
+    {
+        int b = in_.get();
+        if (b == std::char_traits<char>::eof() || shift > 63)
+        {
+            throw std::runtime_error("truncated trace");
+        }
+        x |= (uint64_t)(b & 0x7f) << shift;
+        if ((b & 0x80) == 0)
+        {
+            return x;
+        }
+    }
+}
+
+/**
+ * Reads an iterator id, which must be below NO_ITERATOR.
+ */
+template <class Key, class Value>
+uint32_t TraceReader<Key, Value>::readIterator()
+{
+    uint64_t id = readVarint();
+    if (id >= TraceWriter<Key, Value>::NO_ITERATOR)
+    {
+        throw std::runtime_error("bad iterator id in trace");
+    }
+    return (uint32_t)id;
+}
+
+template <class Key, class Value>
+template <typename T>
+void TraceReader<Key, Value>::readRaw(T &x)
+{
+    if (!in_.read(reinterpret_cast<char *>(&x), sizeof(T)))
+    {
+        throw std::runtime_error("truncated trace");
+    }
+}
+
+/*
+  --------------------------------------------
+  End implementations for the trace classes.
+  --------------------------------------------
+*/
+
+/*
+  ---------------------------------------------------
+  Begin implementations for the TracedTree class.
+  ---------------------------------------------------
+*/
+
+template <class Key, class Value, class Tree>
+TracedTree<Key, Value, Tree>::iterator::iterator()
+    : owner_(nullptr), writer_(nullptr), id_(TraceWriter<Key, Value>::NO_ITERATOR)
+{
+}
+
+/**
+ * Wraps it under id, which was taken from owner's writer (NO_ITERATOR when
+ * the tree is not traced).
+ */
+template <class Key, class Value, class Tree>
+TracedTree<Key, Value, Tree>::iterator::iterator(const typename Tree::iterator &it,
+                                                 const TracedTree<Key, Value, Tree> *owner, uint32_t id)
+    : Tree::iterator(it), owner_(owner), writer_(owner->writer_), id_(id)
+{
+}
+
+/**
+ * A copy of a traced iterator gets an id of its own, so that the two can
+ * move apart in the replay too.
+ */
+template <class Key, class Value, class Tree>
+TracedTree<Key, Value, Tree>::iterator::iterator(const iterator &other)
+    : Tree::iterator(other), owner_(other.owner_), writer_(other.tracing()),
+      id_(TraceWriter<Key, Value>::NO_ITERATOR)
+{
+    if (writer_ != nullptr)
+    {
+        id_ = writer_->acquireIterator();
+        writer_->copy(id_, other.id_);
+    }
+}
+
+template <class Key, class Value, class Tree>
+TracedTree<Key, Value, Tree>::iterator::iterator(iterator &&other)
+    : Tree::iterator(other), owner_(other.owner_), writer_(other.writer_), id_(other.id_)
+{
+    other.id_ = TraceWriter<Key, Value>::NO_ITERATOR;
+}
+
+template <class Key, class Value, class Tree>
+TracedTree<Key, Value, Tree>::iterator::~iterator()
+{
+    release();
+}
+
+/**
+ * Keeps this iterator's id, if it has one from the same writer, and records
+ * the copy under it.
+ */
+template <class Key, class Value, class Tree>
+typename TracedTree<Key, Value, Tree>::iterator &TracedTree<Key, Value, Tree>::iterator::operator=(
+    const iterator &other)
+{
+    if (this == &other)
+    {
+        return *this;
+    }
+    TraceWriter<Key, Value> *writer = other.tracing();
+    if (writer == nullptr || tracing() != writer)
+    {
+        release();
+        id_ = (writer != nullptr) ? writer->acquireIterator() : TraceWriter<Key, Value>::NO_ITERATOR;
+    }
+    Tree::iterator::operator=(other);
+    owner_ = other.owner_;
+    writer_ = writer;
+    if (writer != nullptr)
+    {
+        writer->copy(id_, other.id_);
+    }
+    return *this;
+}
+
+template <class Key, class Value, class Tree>
+typename TracedTree<Key, Value, Tree>::iterator &TracedTree<Key, Value, Tree>::iterator::operator=(iterator &&other)
+{
+    if (this != &other)
+    {
+        release();
+        Tree::iterator::operator=(other);
+        owner_ = other.owner_;
+        writer_ = other.writer_;
+        id_ = other.id_;
+        other.id_ = TraceWriter<Key, Value>::NO_ITERATOR;
+    }
+    return *this;
+}
+
+/**
+ * Traces the increment, then makes it.
+ */
+template <class Key, class Value, class Tree>
+typename TracedTree<Key, Value, Tree>::iterator &TracedTree<Key, Value, Tree>::iterator::operator++()
+{
+    TraceWriter<Key, Value> *writer = tracing();
+    if (writer != nullptr)
+    {
+        writer->next(id_);
+    }
+    Tree::iterator::operator++();
+    return *this;
+}
+
+template <class Key, class Value, class Tree>
+typename TracedTree<Key, Value, Tree>::iterator TracedTree<Key, Value, Tree>::iterator::operator++(int)
+{
+    iterator before(*this);
+    ++(*this);
+    return before;
+}
+
+/**
+ * Returns the writer to trace this iterator's calls to, or NULL if it has
+ * no id or the writer it came from is no longer attached to the tree.
+ */
+template <class Key, class Value, class Tree>
+TraceWriter<Key, Value> *TracedTree<Key, Value, Tree>::iterator::tracing() const
+{
+    if (id_ == TraceWriter<Key, Value>::NO_ITERATOR || owner_ == nullptr || owner_->writer_ != writer_)
+    {
+        return nullptr;
+    }
+    return writer_;
+}
+
+/**
+ * Gives the id back to the writer for reuse.
+ */
+template <class Key, class Value, class Tree>
+void TracedTree<Key, Value, Tree>::iterator::release()
+{
+    TraceWriter<Key, Value> *writer = tracing();
+    if (writer != nullptr)
+    {
+        writer->releaseIterator(id_);
+    }
+    id_ = TraceWriter<Key, Value>::NO_ITERATOR;
+}
+
+/**
+ * Default constructor, which starts without a trace attached.
+ */
+template <class Key, class Value, class Tree>
+TracedTree<Key, Value, Tree>::TracedTree() : writer_(nullptr)
+{
+}
+
+template <class Key, class Value, class Tree>
+TracedTree<Key, Value, Tree>::~TracedTree()
+{
+}
+
+/**
+ * Starts writing calls to writer, which must stay alive until stopTrace()
+ * or the tree's destruction.
+ */
+template <class Key, class Value, class Tree>
+void TracedTree<Key, Value, Tree>::startTrace(TraceWriter<Key, Value> *writer)
+{
+    writer_ = writer;
+}
+
+/**
+ * Detaches the writer, flushing what it has pending.
+ */
+template <class Key, class Value, class Tree>
+void TracedTree<Key, Value, Tree>::stopTrace()
+{
+    if (writer_ != nullptr)
+    {
+        writer_->flush();
+    }
+    writer_ = nullptr;
+}
+
+template <class Key, class Value, class Tree>
+void TracedTree<Key, Value, Tree>::insert(const std::pair<const Key, Value> &keyValuePair)
+{
+    if (writer_ != nullptr)
+    {
+        writer_->insert(keyValuePair.first, keyValuePair.second);
+    }
+    Tree::insert(keyValuePair);
+}
+
+template <class Key, class Value, class Tree>
+void TracedTree<Key, Value, Tree>::remove(const Key &key)
+{
+    if (writer_ != nullptr)
+    {
+        writer_->remove(key);
+    }
+    Tree::remove(key);
+}
+
+template <class Key, class Value, class Tree>
+typename TracedTree<Key, Value, Tree>::iterator TracedTree<Key, Value, Tree>::find(const Key &key) const
+{
+    uint32_t id = TraceWriter<Key, Value>::NO_ITERATOR;
+    if (writer_ != nullptr)
+    {
+        id = writer_->acquireIterator();
+        writer_->find(id, key);
+    }
+    return iterator(Tree::find(key), this, id);
+}
+
+template <class Key, class Value, class Tree>
+typename TracedTree<Key, Value, Tree>::iterator TracedTree<Key, Value, Tree>::begin() const
+{
+    uint32_t id = TraceWriter<Key, Value>::NO_ITERATOR;
+    if (writer_ != nullptr)
+    {
+        id = writer_->acquireIterator();
+        writer_->begin(id);
+    }
+    return iterator(Tree::begin(), this, id);
+}
+
+/**
+ * Not traced: comparing against end() is not a call on the tree's data.
+ */
+template <class Key, class Value, class Tree>
+typename TracedTree<Key, Value, Tree>::iterator TracedTree<Key, Value, Tree>::end() const
+{
+    return iterator(Tree::end(), this, TraceWriter<Key, Value>::NO_ITERATOR);
+}
+
+/*
+  -------------------------------------------------
+  End implementations for the TracedTree class.
+  -------------------------------------------------
+*/
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef TREE_PROFILE_H
+#define TREE_PROFILE_H
+
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <vector>
+
+/**
+ * The shape of a search tree (or subtree), as reported by
+ * BinarySearchTree::profile(). Depths count from the profiled root at 0, and
+ * a search path's length is the number of nodes it compares against, so a
+ * successful search for a node at depth d has a path of length d + 1.
+ */
+struct TreeProfile
+{
+    size_t nodes;
+    size_t leaves;
+    std::vector<size_t> depthCounts;     // nodes at each depth
+    std::map<int, size_t> balanceCounts; // nodes by right minus left height
+    double averagePathLength;            // mean over all nodes
+    size_t maxPathLength;                // the height of the tree
+    double optimalPathLength;            // mean for a perfectly balanced tree of as many nodes
+
+    TreeProfile() : nodes(0), leaves(0), averagePathLength(0), maxPathLength(0), optimalPathLength(0) {}
+
+    void addNode(size_t depth, int balance, bool leaf);
+    void finish();
+    void writeJson(std::ostream &out) const;
+
+    static double optimalAverage(size_t n);
+};
+
+/**
+ * Counts one node of the profiled tree.
+ */
+inline void TreeProfile::addNode(size_t depth, int balance, bool leaf)
+{
+    if (depthCounts.size() <= depth)
+    {
+        depthCounts.resize(depth + 1, 0);
+    }
+    ++depthCounts[depth];
+    ++balanceCounts[balance];
+    ++nodes;
+    if (leaf)
+    {
+        ++leaves;
+    }
+}
+
+/**
+ * Derives the path lengths once every node has been added.
+ */
+inline void TreeProfile::finish()
+{
+    double total = 0;
+    for (size_t d = 0; d < depthCounts.size(); ++d)
+    {
+        total += (double)depthCounts[d] * (double)(d + 1);
+    }
+    averagePathLength = (nodes == 0) ? 0 : total / (double)nodes;
+    maxPathLength = depthCounts.size();
+    optimalPathLength = optimalAverage(nodes);
+}
+
+/**
+ * Writes the profile as one JSON object.
+ */
+inline void TreeProfile::writeJson(std::ostream &out) const
+{
+    out << "{\"nodes\":" << nodes << ",\"leaves\":" << leaves << ",\"averagePathLength\":" << averagePathLength
+        << ",\"maxPathLength\":" << maxPathLength << ",\"optimalPathLength\":" << optimalPathLength
+        << ",\"depthCounts\":[";
+    for (size_t d = 0; d < depthCounts.size(); ++d)
+    {
+        out << (d == 0 ? "" : ",") << depthCounts[d];
+    }
+    out << "],\"balanceCounts\":{";
+    for (std::map<int, size_t>::const_iterator it = balanceCounts.begin(); it != balanceCounts.end(); ++it)
+    {
+        out << (it == balanceCounts.begin() ? "" : ",") << "\"" << it->first << "\":" << it->second;
+    }
+    out << "}}";
+}
+
+/**
+ * Returns the mean search path length of a tree of n nodes with every level
+ * but the last full, which no binary search tree can beat.
+ */
+inline double TreeProfile::optimalAverage(size_t n)
+{
+    if (n == 0)
+    {
+        return 0;
+    }
+    double total = 0;
+    size_t left = n;
+    size_t level = 1;
+    for (size_t d = 1; left > 0; ++d, level *= 2)
+    {
+        size_t here = (left < level) ? left : level;
+        total += (double)here * (double)d;
+        left -= here;
+    }
+    return total / (double)n;
+}
+
+#endif
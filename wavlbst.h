@@ -0,0 +1,584 @@
+#ifndef WAVLBST_H
+#define WAVLBST_H
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <cstdint>
+#include <algorithm>
+#include "bst.h"
+
+/**
+ * A special kind of node for a weak AVL (rank-balanced) tree, which adds the
+ * rank as a data member. A missing child has rank -1.
+ */
+template <typename Key, typename Value>
+class WAVLNode : public Node<Key, Value>
+{
+public:
+    // Constructor/destructor.
+    WAVLNode(const Key &key, const Value &value, WAVLNode<Key, Value> *parent);
+    virtual ~WAVLNode();
+
+    // Getter/setter for the node's rank.
+    int8_t getRank() const;
+    void setRank(int8_t rank);
+    void updateRank(int8_t diff);
+
+    // Getters for parent, left, and right. These need to be redefined since they
+    // return pointers to WAVLNodes - not plain Nodes. See the Node class in bst.h
+    // for more information.
+    virtual WAVLNode<Key, Value> *getParent() const override;
+    virtual WAVLNode<Key, Value> *getLeft() const override;
+    virtual WAVLNode<Key, Value> *getRight() const override;
+
+protected:
+    int8_t rank_;
+};
+
+/*
+  -------------------------------------------------
+  Begin implementations for the WAVLNode class.
+  -------------------------------------------------
+*/
+
+/**
+ * An explicit constructor to initialize the elements by calling the base class constructor and setting
+ * the rank to 0 since every new node is a leaf when it is first inserted.
+ */
+template <class Key, class Value>
+WAVLNode<Key, Value>::WAVLNode(const Key &key, const Value &value, WAVLNode<Key, Value> *parent) : Node<Key, Value>(key, value, parent), rank_(0)
+{
+}
+
+/**
+ * A destructor which does nothing.
+ */
+template <class Key, class Value>
+WAVLNode<Key, Value>::~WAVLNode()
+{
+}
+
+/**
+ * A getter for the rank of a WAVLNode.
+ */
+template <class Key, class Value>
+int8_t WAVLNode<Key, Value>::getRank() const
+{
+    return rank_;
+}
+
+/**
+ * A setter for the rank of a WAVLNode.
+ */
+template <class Key, class Value>
+void WAVLNode<Key, Value>::setRank(int8_t rank)
+{
+    rank_ = rank;
+}
+
+/**
+ * Adds diff to the rank of a WAVLNode.
+ */
+template <class Key, class Value>
+void WAVLNode<Key, Value>::updateRank(int8_t diff)
+{
+    rank_ += diff;
+}
+
+/**
+ * An overridden function for getting the parent since a static_cast is necessary to make sure
+ * that our node is a WAVLNode.
+ */
+template <class Key, class Value>
+WAVLNode<Key, Value> *WAVLNode<Key, Value>::getParent() const
+{
+    return static_cast<WAVLNode<Key, Value> *>(this->parent_);
+}
+
+/**
+ * Overridden for the same reasons as above.
+ */
+template <class Key, class Value>
+WAVLNode<Key, Value> *WAVLNode<Key, Value>::getLeft() const
+{
+    return static_cast<WAVLNode<Key, Value> *>(this->left_);
+}
+
+/**
+ * Overridden for the same reasons as above.
+ */
+template <class Key, class Value>
+WAVLNode<Key, Value> *WAVLNode<Key, Value>::getRight() const
+{
+    return static_cast<WAVLNode<Key, Value> *>(this->right_);
+}
+
+/*
+  -----------------------------------------------
+  End implementations for the WAVLNode class.
+  -----------------------------------------------
+*/
+
+/**
+ * Running totals of the rebalancing work done by a WAVLTree.
+ */
+struct WAVLStats
+{
+    unsigned long inserts;
+    unsigned long insertRotations;
+    unsigned long insertRankChanges;
+    unsigned long removes;
+    unsigned long removeRotations;
+    unsigned long removeRankChanges;
+};
+
+/**
+ * A weak AVL tree (Haeupler, Sen and Tarjan, "Rank-Balanced Trees"). Every
+ * node has a rank, every rank difference between a parent and child is 1 or
+ * 2, and every leaf has rank 0. With only inserts this is exactly an AVL tree;
+ * unlike AVLTree::removeFix, a remove does at most two rotations and O(1)
+ * amortized rank changes, since demotions only run up through 2,2 nodes that
+ * earlier inserts paid for.
+ */
+template <class Key, class Value>
+class WAVLTree : public BinarySearchTree<Key, Value>
+{
+public:
+    WAVLTree();
+    virtual void insert(const std::pair<const Key, Value> &new_item);
+
+    const WAVLStats &getStats() const;
+    void resetStats();
+
+protected:
+    virtual void nodeSwap(WAVLNode<Key, Value> *n1, WAVLNode<Key, Value> *n2);
+    virtual void removeNode(Node<Key, Value> *node);
+    virtual bool relinkable() const;
+    virtual Node<Key, Value> *attachLeaf(Node<Key, Value> *parent, const std::pair<const Key, Value> &new_item);
+
+    // Helper functions
+    static int rank(WAVLNode<Key, Value> *n);
+    void promote(WAVLNode<Key, Value> *n, unsigned long &counter);
+    void demote(WAVLNode<Key, Value> *n, unsigned long &counter);
+    void insertFix(WAVLNode<Key, Value> *x, WAVLNode<Key, Value> *p);
+    void removeFix(WAVLNode<Key, Value> *x, WAVLNode<Key, Value> *p);
+    void rotateLeft(WAVLNode<Key, Value> *n, unsigned long &counter);
+    void rotateRight(WAVLNode<Key, Value> *n, unsigned long &counter);
+
+    WAVLStats stats_;
+};
+
+/*
+  ---------------------------------------------
+  Begin implementations for the WAVLTree class.
+  ---------------------------------------------
+*/
+
+/**
+ * Default constructor, which starts with empty statistics.
+ */
+template <class Key, class Value>
+WAVLTree<Key, Value>::WAVLTree()
+{
+    resetStats();
+}
+
+/**
+ * Returns the rebalancing counters accumulated since construction or the
+ * last resetStats().
+ */
+template <class Key, class Value>
+const WAVLStats &WAVLTree<Key, Value>::getStats() const
+{
+    return stats_;
+}
+
+template <class Key, class Value>
+void WAVLTree<Key, Value>::resetStats()
+{
+    stats_.inserts = 0;
+    stats_.insertRotations = 0;
+    stats_.insertRankChanges = 0;
+    stats_.removes = 0;
+    stats_.removeRotations = 0;
+    stats_.removeRankChanges = 0;
+}
+
+/**
+ * The rank of a node, with missing nodes having rank -1.
+ */
+template <class Key, class Value>
+int WAVLTree<Key, Value>::rank(WAVLNode<Key, Value> *n)
+{
+    return (n == nullptr) ? -1 : n->getRank();
+}
+
+template <class Key, class Value>
+void WAVLTree<Key, Value>::promote(WAVLNode<Key, Value> *n, unsigned long &counter)
+{
+    n->updateRank(1);
+    ++counter;
+}
+
+template <class Key, class Value>
+void WAVLTree<Key, Value>::demote(WAVLNode<Key, Value> *n, unsigned long &counter)
+{
+    n->updateRank(-1);
+    ++counter;
+}
+
+/*
+ * If key is already in the tree, the current value is overwritten with the
+ * updated value and no rebalancing is needed.
+ */
+template <class Key, class Value>
+void WAVLTree<Key, Value>::insert(const std::pair<const Key, Value> &new_item)
+{
+    WAVLNode<Key, Value> *parent = nullptr;
+    WAVLNode<Key, Value> *c = static_cast<WAVLNode<Key, Value> *>(this->root_);
+
+    // walking down to the insertion point
+    while (c != nullptr)
+    {
+        parent = c;
+        if (new_item.first < c->getKey())
+        {
+            c = c->getLeft();
+        }
+        else if (new_item.first > c->getKey())
+        {
+            c = c->getRight();
+        }
+        else
+        {
+            c->setValue(new_item.second);
+            return;
+        }
+    }
+
+    attachLeaf(parent, new_item);
+}
+
+/**
+ * Links a new rank-0 leaf under parent and restores the rank rule.
+ */
+template <class Key, class Value>
+Node<Key, Value> *WAVLTree<Key, Value>::attachLeaf(Node<Key, Value> *parent,
+                                                   const std::pair<const Key, Value> &new_item)
+{
+    WAVLNode<Key, Value> *p = static_cast<WAVLNode<Key, Value> *>(parent);
+    WAVLNode<Key, Value> *n = this->createNode(new_item.first, new_item.second, p);
+    ++stats_.inserts;
+    if (p == nullptr)
+    {
+        this->root_ = n;
+        this->noteLinked(n);
+        return n;
+    }
+    if (new_item.first < p->getKey())
+    {
+        p->setLeft(n);
+    }
+    else
+    {
+        p->setRight(n);
+    }
+    this->noteLinked(n);
+    insertFix(n, p);
+    return n;
+}
+
+/**
+ * Restores the rank rule after x became a 0-child of p: promote up the tree
+ * while the sibling is a 1-child, then finish with at most two rotations.
+ */
+template <class Key, class Value>
+void WAVLTree<Key, Value>::insertFix(WAVLNode<Key, Value> *x, WAVLNode<Key, Value> *p)
+{
+    while (p != nullptr && rank(p) == rank(x))
+    {
+        bool xIsLeft = (p->getLeft() == x);
+        WAVLNode<Key, Value> *s = xIsLeft ? p->getRight() : p->getLeft();
+        if (rank(p) - rank(s) == 1)
+        {
+            promote(p, stats_.insertRankChanges);
+            x = p;
+            p = p->getParent();
+            continue;
+        }
+
+        // the sibling is a 2-child
+        if (xIsLeft)
+        {
+            WAVLNode<Key, Value> *y = x->getRight();
+            if (y == nullptr || rank(x) - rank(y) == 2)
+            {
+                rotateRight(p, stats_.insertRotations);
+                demote(p, stats_.insertRankChanges);
+            }
+            else
+            {
+                rotateLeft(x, stats_.insertRotations);
+                rotateRight(p, stats_.insertRotations);
+                promote(y, stats_.insertRankChanges);
+                demote(x, stats_.insertRankChanges);
+                demote(p, stats_.insertRankChanges);
+            }
+        }
+        else
+        {
+            WAVLNode<Key, Value> *y = x->getLeft();
+            if (y == nullptr || rank(x) - rank(y) == 2)
+            {
+                rotateLeft(p, stats_.insertRotations);
+                demote(p, stats_.insertRankChanges);
+            }
+            else
+            {
+                rotateRight(x, stats_.insertRotations);
+                rotateLeft(p, stats_.insertRotations);
+                promote(y, stats_.insertRankChanges);
+                demote(x, stats_.insertRankChanges);
+                demote(p, stats_.insertRankChanges);
+            }
+        }
+        break;
+    }
+}
+
+/*
+ * As in the other trees, a node with 2 children is swapped with its
+ * predecessor first so that the node actually unlinked has at most one child.
+ */
+template <class Key, class Value>
+void WAVLTree<Key, Value>::removeNode(Node<Key, Value> *node)
+{
+    WAVLNode<Key, Value> *n = static_cast<WAVLNode<Key, Value> *>(node);
+    if (n->getLeft() != nullptr && n->getRight() != nullptr)
+    {
+        nodeSwap(n, static_cast<WAVLNode<Key, Value> *>(this->predecessor(n)));
+    }
+
+    WAVLNode<Key, Value> *child = (n->getLeft() != nullptr) ? n->getLeft() : n->getRight();
+    WAVLNode<Key, Value> *p = n->getParent();
+
+    // splicing n out
+    this->noteUnlinking(n);
+    if (p == nullptr)
+    {
+        this->root_ = child;
+    }
+    else if (p->getLeft() == n)
+    {
+        p->setLeft(child);
+    }
+    else
+    {
+        p->setRight(child);
+    }
+    if (child != nullptr)
+    {
+        child->setParent(p);
+    }
+    this->destroyNode(n);
+
+    ++stats_.removes;
+    removeFix(child, p);
+}
+
+/**
+ * Restores the rank rule after x (which may be NULL) replaced a removed child
+ * of p: fix a 2,2 leaf, demote up the tree while x is a 3-child whose sibling
+ * is a 2-child or a 2,2 node, then finish with at most two rotations.
+ */
+template <class Key, class Value>
+void WAVLTree<Key, Value>::removeFix(WAVLNode<Key, Value> *x, WAVLNode<Key, Value> *p)
+{
+    if (p == nullptr)
+    {
+        return;
+    }
+
+    // a leaf must have rank 0
+    if (p->getLeft() == nullptr && p->getRight() == nullptr && rank(p) == 1)
+    {
+        demote(p, stats_.removeRankChanges);
+        x = p;
+        p = p->getParent();
+    }
+
+    while (p != nullptr && rank(p) - rank(x) == 3)
+    {
+        // x is a 3-child, so its sibling exists (p cannot be a leaf)
+        WAVLNode<Key, Value> *y = (p->getLeft() == x) ? p->getRight() : p->getLeft();
+        if (rank(p) - rank(y) == 2)
+        {
+            demote(p, stats_.removeRankChanges);
+        }
+        else if (rank(y) - rank(y->getLeft()) == 2 && rank(y) - rank(y->getRight()) == 2)
+        {
+            demote(p, stats_.removeRankChanges);
+            demote(y, stats_.removeRankChanges);
+        }
+        else
+        {
+            break;
+        }
+        x = p;
+        p = p->getParent();
+    }
+
+    if (p == nullptr || rank(p) - rank(x) != 3)
+    {
+        return;
+    }
+
+    // the sibling y is a 1-child with at least one 1-child: rotate
+    WAVLNode<Key, Value> *z = p;
+    if (z->getLeft() == x)
+    {
+        WAVLNode<Key, Value> *y = z->getRight();
+        WAVLNode<Key, Value> *v = y->getLeft();
+        WAVLNode<Key, Value> *w = y->getRight();
+        if (rank(y) - rank(w) == 1)
+        {
+            rotateLeft(z, stats_.removeRotations);
+            promote(y, stats_.removeRankChanges);
+            demote(z, stats_.removeRankChanges);
+            if (z->getLeft() == nullptr && z->getRight() == nullptr)
+            {
+                demote(z, stats_.removeRankChanges);
+            }
+        }
+        else
+        {
+            rotateRight(y, stats_.removeRotations);
+            rotateLeft(z, stats_.removeRotations);
+            v->updateRank(2);
+            demote(y, stats_.removeRankChanges);
+            z->updateRank(-2);
+            stats_.removeRankChanges += 4;
+        }
+    }
+    else
+    {
+        WAVLNode<Key, Value> *y = z->getLeft();
+        WAVLNode<Key, Value> *v = y->getRight();
+        WAVLNode<Key, Value> *w = y->getLeft();
+        if (rank(y) - rank(w) == 1)
+        {
+            rotateRight(z, stats_.removeRotations);
+            promote(y, stats_.removeRankChanges);
+            demote(z, stats_.removeRankChanges);
+            if (z->getLeft() == nullptr && z->getRight() == nullptr)
+            {
+                demote(z, stats_.removeRankChanges);
+            }
+        }
+        else
+        {
+            rotateLeft(y, stats_.removeRotations);
+            rotateRight(z, stats_.removeRotations);
+            v->updateRank(2);
+            demote(y, stats_.removeRankChanges);
+            z->updateRank(-2);
+            stats_.removeRankChanges += 4;
+        }
+    }
+}
+
+/**
+ * Swaps the positions of two nodes and their ranks, so that the ranks stay
+ * attached to the positions in the tree.
+ */
+template <class Key, class Value>
+void WAVLTree<Key, Value>::nodeSwap(WAVLNode<Key, Value> *n1, WAVLNode<Key, Value> *n2)
+{
+    BinarySearchTree<Key, Value>::nodeSwap(n1, n2);
+    int8_t tempR = n1->getRank();
+    n1->setRank(n2->getRank());
+    n2->setRank(tempR);
+}
+
+template <class Key, class Value>
+void WAVLTree<Key, Value>::rotateLeft(WAVLNode<Key, Value> *n, unsigned long &counter)
+{
+    WAVLNode<Key, Value> *r = n->getRight();
+    WAVLNode<Key, Value> *p = n->getParent();
+
+    // rotation
+    n->setRight(r->getLeft());
+    if (r->getLeft() != nullptr)
+    {
+        r->getLeft()->setParent(n);
+    }
+
+    // changing pointers
+    if (p == nullptr)
+    {
+        this->root_ = r;
+    }
+    else if (p->getLeft() == n)
+    {
+        p->setLeft(r);
+    }
+    else
+    {
+        p->setRight(r);
+    }
+    r->setParent(p);
+    r->setLeft(n);
+    n->setParent(r);
+    ++counter;
+}
+
+template <class Key, class Value>
+void WAVLTree<Key, Value>::rotateRight(WAVLNode<Key, Value> *n, unsigned long &counter)
+{
+    WAVLNode<Key, Value> *l = n->getLeft();
+    WAVLNode<Key, Value> *p = n->getParent();
+
+    // rotation
+    n->setLeft(l->getRight());
+    if (l->getRight() != nullptr)
+    {
+        l->getRight()->setParent(n);
+    }
+
+    // changing pointers
+    if (p == nullptr)
+    {
+        this->root_ = l;
+    }
+    else if (p->getLeft() == n)
+    {
+        p->setLeft(l);
+    }
+    else
+    {
+        p->setRight(l);
+    }
+    l->setParent(p);
+    l->setRight(n);
+    n->setParent(l);
+    ++counter;
+}
+
+/**
+ * A DSW rebuild would leave the ranks in the nodes stale, and the tree keeps
+ * itself balanced anyway, so rebalance() and setAutoRebalance() refuse.
+ */
+template <class Key, class Value>
+bool WAVLTree<Key, Value>::relinkable() const
+{
+    return false;
+}
+
+/*
+  -------------------------------------------
+  End implementations for the WAVLTree class.
+  -------------------------------------------
+*/
+
+#endif